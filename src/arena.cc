@@ -0,0 +1,40 @@
+#include "arena.hh"
+
+#include <cstdint>
+
+Arena::Arena(size_t chunkSize)
+  : cursor(nullptr), limit(nullptr), chunkSize(chunkSize) {
+}
+
+Arena::~Arena() {
+    reset();
+}
+
+void Arena::reset() {
+    // Run pending destructors in reverse construction order.
+    for (auto it = finalizers.rbegin(); it != finalizers.rend(); ++it) {
+        it->destroy(it->object);
+    }
+    finalizers.clear();
+    for (char* chunk : chunks) {
+        delete[] chunk;
+    }
+    chunks.clear();
+    cursor = nullptr;
+    limit = nullptr;
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    uintptr_t current = reinterpret_cast<uintptr_t>(cursor);
+    uintptr_t aligned = (current + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    if (cursor == nullptr || aligned + size > reinterpret_cast<uintptr_t>(limit)) {
+        size_t allocation = size + alignment > chunkSize ? size + alignment : chunkSize;
+        char* chunk = new char[allocation];
+        chunks.push_back(chunk);
+        current = reinterpret_cast<uintptr_t>(chunk);
+        aligned = (current + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        limit = chunk + allocation;
+    }
+    cursor = reinterpret_cast<char*>(aligned + size);
+    return reinterpret_cast<void*>(aligned);
+}
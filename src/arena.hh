@@ -0,0 +1,55 @@
+#ifndef _ARENA_HH_
+#define _ARENA_HH_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bump allocator for AST nodes. Nodes are carved out of large chunks,
+// handed out as raw pointers, and released wholesale when the arena is
+// reset or destroyed, so a reduction never pays per-node malloc/free or
+// shared_ptr refcount traffic.
+class Arena {
+public:
+    Arena(size_t chunkSize = 64 * 1024);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        void* memory = allocate(sizeof(T), alignof(T));
+        T* object = new (memory) T(std::forward<Args>(args)...);
+        ++objects;
+        if (!std::is_trivially_destructible<T>::value) {
+            finalizers.push_back({ object, [](void* p) { static_cast<T*>(p)->~T(); } });
+        }
+        return object;
+    }
+
+    // Destroy every allocated object and recycle the chunks.
+    void reset();
+
+    // Objects handed out since construction (reset does not clear it);
+    // cheap enough to keep in production builds.
+    size_t objects = 0;
+
+private:
+    void* allocate(size_t size, size_t alignment);
+
+    struct Finalizer {
+        void* object;
+        void (*destroy)(void*);
+    };
+
+    std::vector<char*> chunks;
+    std::vector<Finalizer> finalizers;
+    char* cursor;
+    char* limit;
+    size_t chunkSize;
+};
+
+#endif // !_ARENA_HH_
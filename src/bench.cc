@@ -0,0 +1,122 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+
+#include "arena.hh"
+#include "debruijn.hh"
+#include "expr.hh"
+#include "parser.hh"
+#include "string.hh"
+
+// Benchmark harness: drives Lexer, Parser and the reduction engine
+// directly over a fixed corpus and reports steps/second, node
+// allocations and peak RSS per case, so regressions in the hot path
+// show up as numbers instead of hunches.
+
+static long peakRssKb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// (λf x.f (f (... (f x)))) with n applications of f.
+static std::string churchNumeral(int n) {
+    std::string source = "(λf x.";
+    for (int i = 0; i < n; ++i) source += "f (";
+    source += "x";
+    for (int i = 0; i < n; ++i) source += ")";
+    source += ")";
+    return source;
+}
+
+// `native` leaves the Church-arithmetic fast path enabled; the generic
+// rows disable it, since a short-circuited reduction reports 0 steps
+// and measures nothing about the engine.
+static void runReduction(const std::string& name, const std::string& source,
+                         bool native = false) {
+    auto start = std::chrono::steady_clock::now();
+    Lexer lexer(source);
+    Arena arena;
+    TermCache cache(arena);
+    cache.stepLimit = 100000000;
+    cache.nativeArith = native;
+    Parser parser(lexer, arena);
+    Term* reduced = normalize(compile(parser.parse(), cache), cache);
+    String rendered = readback(reduced, cache)->toString();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    double seconds = elapsed / 1e6;
+    std::cout << name << ": "
+              << cache.stepsTaken << " steps, "
+              << static_cast<long>(cache.stepsTaken / (seconds > 0 ? seconds : 1e-9)) << " steps/s, "
+              << arena.objects << " nodes, "
+              << elapsed / 1000.0 << " ms, "
+              << "peak rss " << peakRssKb() << " kB"
+              << (cache.exhausted ? " (fuel exhausted!)" : "")
+              << std::endl;
+    (void)rendered;
+}
+
+static void runParseStress(int depth) {
+    std::string source;
+    for (int i = 0; i < depth; ++i) source += "(";
+    source += "λx.x";
+    for (int i = 0; i < depth; ++i) source += ")";
+    auto start = std::chrono::steady_clock::now();
+    Lexer lexer(source);
+    Arena arena;
+    Parser parser(lexer, arena);
+    ExprPtr expr = parser.parse();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "parse nesting depth " << depth << ": "
+              << elapsed / 1000.0 << " ms, "
+              << arena.objects << " nodes" << std::endl;
+    (void)expr;
+}
+
+static void runStringMicro(int count) {
+    auto start = std::chrono::steady_clock::now();
+    String accumulated;
+    for (int i = 0; i < count; ++i) {
+        accumulated += Char{ 0x03bb };
+        accumulated += "x";
+    }
+    size_t codepoints = 0;
+    for (size_t i = 0; i < accumulated.length(); ++i) {
+        codepoints += accumulated[i].toCodepoint() != 0 ? 1 : 0;
+    }
+    std::string utf8 = accumulated.toUTF8();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "string/char micro (" << count << " appends): "
+              << elapsed / 1000.0 << " ms, "
+              << codepoints << " codepoints, "
+              << utf8.size() << " utf8 bytes" << std::endl;
+}
+
+int main() {
+    const std::string add = "(λm n f x.m f (n f x))";
+    const std::string mult = "(λm n f x.m (n f) x)";
+    const std::string pow = "(λm n.n m)";
+    const std::string S = "(λx y z.x z (y z))";
+    const std::string K = "(λx y.x)";
+    const std::string I = "(λx.x)";
+
+    runReduction("add 10 10", add + " " + churchNumeral(10) + " " + churchNumeral(10));
+    runReduction("add 50 50", add + " " + churchNumeral(50) + " " + churchNumeral(50));
+    runReduction("mult 10 10", mult + " " + churchNumeral(10) + " " + churchNumeral(10));
+    runReduction("mult 20 20", mult + " " + churchNumeral(20) + " " + churchNumeral(20));
+    runReduction("pow 2 8", pow + " " + churchNumeral(2) + " " + churchNumeral(8));
+    runReduction("pow 2 10", pow + " " + churchNumeral(2) + " " + churchNumeral(10));
+    runReduction("native add 50 50", add + " " + churchNumeral(50) + " " + churchNumeral(50), true);
+    runReduction("native mult 20 20", mult + " " + churchNumeral(20) + " " + churchNumeral(20), true);
+    runReduction("native pow 2 10", pow + " " + churchNumeral(2) + " " + churchNumeral(10), true);
+    runReduction("ski S K K a",S + " " + K + " " + K + " a");
+    runReduction("ski nest", S + " (" + K + " (" + S + " " + I + ")) " + K + " a b");
+    runParseStress(500);
+    runParseStress(5000);
+    runStringMicro(20000);
+    return 0;
+}
@@ -0,0 +1,696 @@
+#include "debruijn.hh"
+
+#include <future>
+#include <iostream>
+#include <unordered_set>
+#include <vector>
+#include "pool.hh"
+
+size_t TermCache::KeyHash::operator()(const Key& key) const {
+    size_t h = static_cast<size_t>(key.kind);
+    h = h * 31 + static_cast<size_t>(key.index + 1);
+    h = h * 31 + std::hash<const void*>()(key.left);
+    h = h * 31 + std::hash<const void*>()(key.right);
+    h = h * 31 + static_cast<size_t>(key.name);
+    return h;
+}
+
+Term* TermCache::var(int index) {
+    return intern({ TermKind::Var, index, nullptr, nullptr, 0 });
+}
+
+Term* TermCache::freeVar(Symbol name) {
+    Key key = { TermKind::Var, -1, nullptr, nullptr, name };
+    auto found = table.find(key);
+    if (found != table.end()) return found->second;
+    Term* term = arena.make<Term>(name);
+    table.emplace(key, term);
+    return term;
+}
+
+Term* TermCache::lam(Symbol hint, Term* body) {
+    Key key = { TermKind::Lam, -1, body, nullptr, 0 };
+    auto found = table.find(key);
+    if (found != table.end()) return found->second;
+    Term* term = arena.make<Term>(hint, body);
+    table.emplace(key, term);
+    return term;
+}
+
+Term* TermCache::app(Term* func, Term* arg) {
+    Key key = { TermKind::App, -1, func, arg, 0 };
+    auto found = table.find(key);
+    if (found != table.end()) return found->second;
+    Term* term = arena.make<Term>(func, arg);
+    table.emplace(key, term);
+    return term;
+}
+
+bool TermCache::spendFuel() {
+    if (exhausted) return false;
+    if (stepsTaken >= stepLimit) {
+        exhausted = true;
+        return false;
+    }
+    // Only poll the clock every so often; a syscall per step would cost
+    // more than the step.
+    if (deadline != std::chrono::steady_clock::time_point{} &&
+        (stepsTaken & 1023) == 0 &&
+        std::chrono::steady_clock::now() > deadline) {
+        exhausted = true;
+        return false;
+    }
+    ++stepsTaken;
+    return true;
+}
+
+void TermCache::noteHint(const Term* term, Symbol hint) {
+    if (hint == term->name) {
+        hints.erase(term);
+    } else {
+        hints[term] = hint;
+    }
+}
+
+Symbol TermCache::hintFor(const Term* term) const {
+    auto found = hints.find(term);
+    return found != hints.end() ? found->second : term->name;
+}
+
+Term* TermCache::intern(const Key& key) {
+    auto found = table.find(key);
+    if (found != table.end()) return found->second;
+    Term* term = arena.make<Term>(key.index);
+    table.emplace(key, term);
+    return term;
+}
+
+// Resolve each bound name to the distance from its binder; variables
+// not bound anywhere stay free and keep their name. Iterative with an
+// explicit frame stack -- like every traversal in this file -- so terms
+// far deeper than the C stack (Church numeral 100000 is one long spine)
+// compile without crashing. Enter frames descend; exit frames rebuild
+// once the children sit on the result stack.
+Term* compile(ExprPtr expr, TermCache& cache) {
+    struct Frame { ExprPtr expr; bool exit; };
+    std::vector<Symbol> scope;
+    std::vector<Frame> frames{ { expr, false } };
+    std::vector<Term*> results;
+    while (!frames.empty()) {
+        Frame frame = frames.back();
+        frames.pop_back();
+        if (!frame.exit) {
+            switch (frame.expr->kind) {
+            case ExprKind::Variable: {
+                auto var = asVariable(frame.expr);
+                Term* made = nullptr;
+                for (size_t i = scope.size(); i > 0; --i) {
+                    if (scope[i - 1] == var->name) {
+                        made = cache.var(static_cast<int>(scope.size() - i));
+                        break;
+                    }
+                }
+                results.push_back(made != nullptr ? made : cache.freeVar(var->name));
+                break;
+            }
+            case ExprKind::Abstraction: {
+                auto abstraction = asAbstraction(frame.expr);
+                scope.push_back(abstraction->param);
+                frames.push_back({ frame.expr, true });
+                frames.push_back({ abstraction->body, false });
+                break;
+            }
+            case ExprKind::Application: {
+                auto application = asApplication(frame.expr);
+                frames.push_back({ frame.expr, true });
+                frames.push_back({ application->arg, false });
+                frames.push_back({ application->func, false });
+                break;
+            }
+            }
+            continue;
+        }
+        if (frame.expr->kind == ExprKind::Abstraction) {
+            scope.pop_back();
+            Term* body = results.back();
+            results.pop_back();
+            Symbol param = asAbstraction(frame.expr)->param;
+            // The interned node may predate this query with another
+            // binder name; the hint map makes this query's name win at
+            // readback.
+            Term* made = cache.lam(param, body);
+            cache.noteHint(made, param);
+            results.push_back(made);
+        } else {
+            Term* arg = results.back();
+            results.pop_back();
+            Term* func = results.back();
+            results.pop_back();
+            results.push_back(cache.app(func, arg));
+        }
+    }
+    return results.back();
+}
+
+// Rebuild a Lam around a transformed body, reusing the original node
+// when nothing changed and carrying its display hint forward otherwise.
+static Term* rebuildLam(Term* original, Term* body, TermCache& cache) {
+    if (body == original->left) return original;
+    Term* made = cache.lam(original->name, body);
+    cache.noteHint(made, cache.hintFor(original));
+    return made;
+}
+
+// Shift free indices >= cutoff by `by`. Returns the original term when
+// nothing below the cutoff moves, preserving sharing.
+static Term* shift(Term* term, int by, int cutoff, TermCache& cache) {
+    if (by == 0) return term;
+    ++cache.shifts;
+    struct Frame { Term* term; int cutoff; bool exit; };
+    std::vector<Frame> frames{ { term, cutoff, false } };
+    std::vector<Term*> results;
+    while (!frames.empty()) {
+        Frame frame = frames.back();
+        frames.pop_back();
+        Term* node = frame.term;
+        if (!frame.exit) {
+            switch (node->kind) {
+            case TermKind::Var:
+                results.push_back(node->index >= frame.cutoff && node->index >= 0
+                                      ? cache.var(node->index + by)
+                                      : node);
+                break;
+            case TermKind::Lam:
+                frames.push_back({ node, frame.cutoff, true });
+                frames.push_back({ node->left, frame.cutoff + 1, false });
+                break;
+            case TermKind::App:
+                frames.push_back({ node, frame.cutoff, true });
+                frames.push_back({ node->right, frame.cutoff, false });
+                frames.push_back({ node->left, frame.cutoff, false });
+                break;
+            }
+            continue;
+        }
+        if (node->kind == TermKind::Lam) {
+            Term* body = results.back();
+            results.pop_back();
+            results.push_back(rebuildLam(node, body, cache));
+        } else {
+            Term* arg = results.back();
+            results.pop_back();
+            Term* func = results.back();
+            results.pop_back();
+            results.push_back(func == node->left && arg == node->right
+                                  ? node
+                                  : cache.app(func, arg));
+        }
+    }
+    return results.back();
+}
+
+// Substitute `value` for index `depth` while removing the contracted
+// binder: indices above `depth` shift down by one in the same pass.
+static Term* substIndex(Term* term, int depth, Term* value, TermCache& cache) {
+    ++cache.substitutions;
+    struct Frame { Term* term; int depth; bool exit; };
+    std::vector<Frame> frames{ { term, depth, false } };
+    std::vector<Term*> results;
+    while (!frames.empty()) {
+        Frame frame = frames.back();
+        frames.pop_back();
+        Term* node = frame.term;
+        if (!frame.exit) {
+            switch (node->kind) {
+            case TermKind::Var:
+                if (node->index == frame.depth) {
+                    results.push_back(shift(value, frame.depth, 0, cache));
+                } else if (node->index > frame.depth) {
+                    results.push_back(cache.var(node->index - 1));
+                } else {
+                    results.push_back(node);
+                }
+                break;
+            case TermKind::Lam:
+                frames.push_back({ node, frame.depth, true });
+                frames.push_back({ node->left, frame.depth + 1, false });
+                break;
+            case TermKind::App:
+                frames.push_back({ node, frame.depth, true });
+                frames.push_back({ node->right, frame.depth, false });
+                frames.push_back({ node->left, frame.depth, false });
+                break;
+            }
+            continue;
+        }
+        if (node->kind == TermKind::Lam) {
+            Term* body = results.back();
+            results.pop_back();
+            results.push_back(rebuildLam(node, body, cache));
+        } else {
+            Term* arg = results.back();
+            results.pop_back();
+            Term* func = results.back();
+            results.pop_back();
+            results.push_back(func == node->left && arg == node->right
+                                  ? node
+                                  : cache.app(func, arg));
+        }
+    }
+    return results.back();
+}
+
+// Reduce the leftmost spine to weak head normal form: keep contracting
+// the head redex in place, never rescanning from the root. The spine of
+// pending applications is an explicit stack, so a left-nested chain of
+// any length walks in constant C-stack space.
+static Term* weakHeadReduce(Term* term, TermCache& cache) {
+    std::vector<Term*> spine;
+    // Nodes held by the pending spine, so the size check sees the whole
+    // term: growth can live entirely in the spine (Ω-style loops keep
+    // the head redex constant-sized) and the contractum alone would
+    // never trip the limit.
+    long pending = 0;
+    Term* current = term;
+    while (true) {
+        if (current->kind == TermKind::App) {
+            spine.push_back(current);
+            pending = combinedSize(pending, current->right->size);
+            current = current->left;
+            continue;
+        }
+        if (spine.empty()) return current;
+        Term* app = spine.back();
+        if (current->kind == TermKind::Lam && cache.spendFuel()) {
+            spine.pop_back();
+            pending -= app->right->size + 1;
+            if (cache.trace) {
+                *cache.trace << Char{ 0x21aa } << " β-reduce: "
+                             << symbols().name(cache.hintFor(current))
+                             << " <- " << readback(app->right, cache)->toString() << "\n";
+            }
+            current = substIndex(current->left, 0, app->right, cache);
+            // Space analogue of fuel: a contraction that grows the term
+            // past the limit stops the machine the same way running out
+            // of steps does, leaving a partial result to hand back.
+            if (cache.sizeLimit != 0 && current->size + pending > cache.sizeLimit) {
+                cache.exhausted = true;
+            }
+            continue;
+        }
+        // Head inert (or fuel spent): reapply the remaining spine,
+        // reusing each original App node when its func is unchanged.
+        Term* result = current;
+        for (auto it = spine.rbegin(); it != spine.rend(); ++it) {
+            result = result == (*it)->left ? *it : cache.app(result, (*it)->right);
+        }
+        return result;
+    }
+}
+
+// --- Native Church arithmetic ----------------------------------------
+// `mult 100 100` costs megabytes of AST churn for what is one integer
+// multiply. When an application's head is (pointer-)equal to one of the
+// standard arithmetic combinators and its arguments normalize to Church
+// numerals, the result numeral is computed natively and spliced in.
+
+// Largest numeral the fast path will materialize; bigger results fall
+// back to the generic engine rather than building a huge term.
+static const long maxNativeNumeral = 1000000;
+
+// The canonical numeral λf.λx.f (f ... (f x)).
+static Term* numeralTerm(long n, TermCache& cache) {
+    Term* body = cache.var(0);
+    for (long i = 0; i < n; ++i) {
+        body = cache.app(cache.var(1), body);
+    }
+    return cache.lam(symbols().intern(std::string("f")),
+                     cache.lam(symbols().intern(std::string("x")), body));
+}
+
+// Shape test: λ.λ.1 (1 ... 0); writes the count into n.
+static bool numeralValue(Term* term, long& n) {
+    if (term->kind != TermKind::Lam || term->left->kind != TermKind::Lam) return false;
+    Term* body = term->left->left;
+    long count = 0;
+    while (body->kind == TermKind::App &&
+           body->left->kind == TermKind::Var && body->left->index == 1) {
+        ++count;
+        body = body->right;
+    }
+    if (body->kind == TermKind::Var && body->index == 0) {
+        n = count;
+        return true;
+    }
+    return false;
+}
+
+// Compile the reference combinators into this cache once. Indices count
+// outward from the innermost binder.
+static void ensureArithRefs(TermCache& cache) {
+    if (cache.arithAdd != nullptr) return;
+    Symbol m = symbols().intern(std::string("m"));
+    Symbol n = symbols().intern(std::string("n"));
+    Symbol f = symbols().intern(std::string("f"));
+    Symbol x = symbols().intern(std::string("x"));
+    auto lam4 = [&](Term* body) {
+        return cache.lam(m, cache.lam(n, cache.lam(f, cache.lam(x, body))));
+    };
+    // add = λm n f x.m f (n f x)
+    cache.arithAdd = lam4(cache.app(
+        cache.app(cache.var(3), cache.var(1)),
+        cache.app(cache.app(cache.var(2), cache.var(1)), cache.var(0))));
+    // mult = λm n f x.m (n f) x
+    cache.arithMult = lam4(cache.app(
+        cache.app(cache.var(3), cache.app(cache.var(2), cache.var(1))),
+        cache.var(0)));
+    // mult, curried spelling: λm n f.m (n f)
+    cache.arithMult3 = cache.lam(m, cache.lam(n, cache.lam(f,
+        cache.app(cache.var(2), cache.app(cache.var(1), cache.var(0))))));
+    // pow = λm n.n m
+    cache.arithPow = cache.lam(m, cache.lam(n,
+        cache.app(cache.var(0), cache.var(1))));
+    // succ = λn f x.f (n f x)
+    cache.arithSucc = cache.lam(n, cache.lam(f, cache.lam(x,
+        cache.app(cache.var(1),
+                  cache.app(cache.app(cache.var(2), cache.var(1)), cache.var(0))))));
+}
+
+// Normalize an argument just far enough to know whether it is a
+// numeral.
+static bool numeralArg(Term* term, TermCache& cache, long& n) {
+    if (numeralValue(term, n)) return true;
+    return numeralValue(normalize(term, cache), n);
+}
+
+// The fast path itself: nullptr means no match and the generic engine
+// proceeds as usual.
+static Term* nativeArithmetic(Term* term, TermCache& cache) {
+    if (term->kind != TermKind::App) return nullptr;
+    ensureArithRefs(cache);
+    long a, b;
+    if (term->left->kind == TermKind::App) {
+        Term* op = term->left->left;
+        if (op != cache.arithAdd && op != cache.arithMult &&
+            op != cache.arithMult3 && op != cache.arithPow) {
+            return nullptr;
+        }
+        if (!numeralArg(term->left->right, cache, a) ||
+            !numeralArg(term->right, cache, b)) {
+            return nullptr;
+        }
+        long result;
+        if (op == cache.arithAdd) {
+            result = a + b;
+        } else if (op == cache.arithPow) {
+            // pow m n = n m = m^n.
+            result = 1;
+            for (long i = 0; i < b; ++i) {
+                result *= a;
+                if (result > maxNativeNumeral) return nullptr;
+            }
+        } else {
+            if (b != 0 && a > maxNativeNumeral / b) return nullptr;
+            result = a * b;
+        }
+        if (result > maxNativeNumeral) return nullptr;
+        return numeralTerm(result, cache);
+    }
+    if (term->left == cache.arithSucc && numeralArg(term->right, cache, a) &&
+        a < maxNativeNumeral) {
+        return numeralTerm(a + 1, cache);
+    }
+    return nullptr;
+}
+
+// Normal-order normalization in a single traversal: contract the
+// leftmost-outermost redex as soon as it appears, then descend into the
+// remaining subterms. The head of an application is inert after weak
+// head reduction, so nothing above the current position needs a rescan.
+Term* normalize(Term* term, TermCache& cache) {
+    // Enter frames memo-check and head-reduce; exit frames rebuild with
+    // the children's normal forms from the result stack.
+    struct Frame { Term* original; Term* whnf; bool exit; };
+    std::vector<Frame> frames{ { term, nullptr, false } };
+    std::vector<Term*> results;
+    // Partial results from an exhausted budget must not be remembered
+    // as normal forms.
+    auto finish = [&](Term* original, Term* result) {
+        if (original->freeBound == 0 && !cache.exhausted) {
+            cache.normalForms.emplace(original, result);
+            // The normal form itself is its own normal form; remember
+            // that too so re-encounters return immediately.
+            cache.normalForms.emplace(result, result);
+        }
+        results.push_back(result);
+    };
+    while (!frames.empty()) {
+        Frame frame = frames.back();
+        frames.pop_back();
+        if (!frame.exit) {
+            Term* original = frame.original;
+            // Closed subterms reduce the same everywhere, so repeated
+            // ones (Church arithmetic is full of them) are computed
+            // only once.
+            if (original->freeBound == 0) {
+                auto found = cache.normalForms.find(original);
+                if (found != cache.normalForms.end()) {
+                    results.push_back(found->second);
+                    continue;
+                }
+            }
+            if (cache.nativeArith) {
+                Term* fast = nativeArithmetic(original, cache);
+                if (fast != nullptr) {
+                    finish(original, fast);
+                    continue;
+                }
+            }
+            Term* whnf = weakHeadReduce(original, cache);
+            switch (whnf->kind) {
+            case TermKind::Var:
+                finish(original, whnf);
+                break;
+            case TermKind::Lam:
+                frames.push_back({ original, whnf, true });
+                frames.push_back({ whnf->left, nullptr, false });
+                break;
+            case TermKind::App:
+                frames.push_back({ original, whnf, true });
+                frames.push_back({ whnf->right, nullptr, false });
+                frames.push_back({ whnf->left, nullptr, false });
+                break;
+            }
+            continue;
+        }
+        Term* whnf = frame.whnf;
+        if (whnf->kind == TermKind::Lam) {
+            Term* body = results.back();
+            results.pop_back();
+            finish(frame.original, rebuildLam(whnf, body, cache));
+        } else {
+            Term* arg = results.back();
+            results.pop_back();
+            Term* func = results.back();
+            results.pop_back();
+            finish(frame.original, func == whnf->left && arg == whnf->right
+                                       ? whnf
+                                       : cache.app(func, arg));
+        }
+    }
+    return results.back();
+}
+
+// --- Parallel normalization ------------------------------------------
+// Once weak head reduction leaves an application inert, its func and
+// arg are disjoint subtrees whose reductions cannot interact, so a
+// coordinator can ship one side to the pool and keep reducing the other
+// itself. Every task owns a private Arena and TermCache (workers never
+// contend); Term nodes are immutable after construction, so tasks may
+// freely read terms built by the parent. The parent adopts each task's
+// arena on join so result nodes outlive the task.
+
+// Subtrees below this many nodes are reduced inline; fork/join overhead
+// swamps anything smaller. Sizes are cached on the nodes, so the test
+// is a single field read.
+static const long parallelCutoff = 512;
+
+namespace {
+struct ReductionTask {
+    std::unique_ptr<Arena> arena;
+    std::unique_ptr<TermCache> cache;
+    Term* result = nullptr;
+    std::promise<void> done;
+    std::future<void> ready;
+};
+}
+
+static std::unique_ptr<ReductionTask> forkNormalize(Term* term, TermCache& parent,
+                                                    ThreadPool& pool) {
+    auto task = std::make_unique<ReductionTask>();
+    task->arena.reset(new Arena());
+    task->cache.reset(new TermCache(*task->arena));
+    // Fuel is accounted per task: each fork starts from the parent's
+    // remaining budget, so the total can overshoot stepLimit by one
+    // budget per fork. Exact accounting would serialize every step on
+    // an atomic counter.
+    task->cache->stepLimit = parent.stepLimit - parent.stepsTaken;
+    task->cache->deadline = parent.deadline;
+    // Workers rebuild around parent nodes, so they need the parent's
+    // display hints to carry them forward.
+    task->cache->hints = parent.hints;
+    task->ready = task->done.get_future();
+    ReductionTask* raw = task.get();
+    pool.submit([raw, term] {
+        raw->result = normalize(term, *raw->cache);
+        raw->done.set_value();
+    });
+    return task;
+}
+
+static Term* joinTask(std::unique_ptr<ReductionTask> task, TermCache& parent) {
+    task->ready.wait();
+    parent.stepsTaken += task->cache->stepsTaken;
+    if (task->cache->exhausted) parent.exhausted = true;
+    Term* result = task->result;
+    // Result nodes live in the task's cache, so its hints for them must
+    // survive the join for readback to see.
+    parent.hints.insert(task->cache->hints.begin(), task->cache->hints.end());
+    parent.adoptedCaches.push_back(std::move(task->cache));
+    parent.adoptedArenas.push_back(std::move(task->arena));
+    return result;
+}
+
+static Term* splitNormalize(Term* term, TermCache& cache, ThreadPool& pool);
+
+// Route a subterm to the splitting coordinator or the plain sequential
+// engine depending on its size.
+static Term* descend(Term* term, TermCache& cache, ThreadPool& pool) {
+    if (term->size < parallelCutoff) {
+        return normalize(term, cache);
+    }
+    return splitNormalize(term, cache, pool);
+}
+
+// Coordinator: runs on the calling thread, contracts the head spine
+// itself (head reduction is inherently sequential) and forks the arg of
+// each large application while it keeps working on the func side.
+static Term* splitNormalize(Term* term, TermCache& cache, ThreadPool& pool) {
+    term = weakHeadReduce(term, cache);
+    switch (term->kind) {
+    case TermKind::Var:
+        return term;
+    case TermKind::Lam: {
+        Term* body = descend(term->left, cache, pool);
+        return rebuildLam(term, body, cache);
+    }
+    case TermKind::App: {
+        Term* func;
+        Term* arg;
+        if (term->right->size >= parallelCutoff && term->left->size >= parallelCutoff) {
+            auto task = forkNormalize(term->right, cache, pool);
+            func = splitNormalize(term->left, cache, pool);
+            arg = joinTask(std::move(task), cache);
+        } else {
+            func = descend(term->left, cache, pool);
+            arg = descend(term->right, cache, pool);
+        }
+        if (func == term->left && arg == term->right) return term;
+        return cache.app(func, arg);
+    }
+    }
+    return term;
+}
+
+Term* normalizeParallel(Term* term, TermCache& cache, ThreadPool& pool) {
+    return descend(term, cache, pool);
+}
+
+// Collect the names of free variables so readback never picks a binder
+// name that would capture one of them.
+static void collectFreeNames(Term* term, std::unordered_set<Symbol>& names) {
+    std::vector<Term*> stack{ term };
+    while (!stack.empty()) {
+        Term* node = stack.back();
+        stack.pop_back();
+        switch (node->kind) {
+        case TermKind::Var:
+            if (node->index < 0) names.insert(node->name);
+            break;
+        case TermKind::Lam:
+            stack.push_back(node->left);
+            break;
+        case TermKind::App:
+            stack.push_back(node->right);
+            stack.push_back(node->left);
+            break;
+        }
+    }
+}
+
+ExprPtr readback(Term* term, TermCache& cache) {
+    Arena& arena = cache.arena;
+    struct Frame { Term* term; Symbol chosen; bool exit; };
+    std::vector<Symbol> scope;
+    std::unordered_set<Symbol> taken;
+    collectFreeNames(term, taken);
+    std::vector<Frame> frames{ { term, 0, false } };
+    std::vector<ExprPtr> results;
+    while (!frames.empty()) {
+        Frame frame = frames.back();
+        frames.pop_back();
+        Term* node = frame.term;
+        if (!frame.exit) {
+            switch (node->kind) {
+            case TermKind::Var:
+                if (node->index < 0) {
+                    results.push_back(arena.make<Variable>(node->name));
+                } else if (node->index >= static_cast<int>(scope.size())) {
+                    // Open subterms (e.g. trace output mid-reduction)
+                    // may reference binders outside this readback; show
+                    // those as #n.
+                    results.push_back(arena.make<Variable>(
+                        symbols().intern("#" + std::to_string(node->index))));
+                } else {
+                    results.push_back(arena.make<Variable>(scope[scope.size() - 1 - node->index]));
+                }
+                break;
+            case TermKind::Lam: {
+                // Reuse this evaluation's display hint unless it would
+                // collide with a name already visible here.
+                Symbol hint = cache.hintFor(node);
+                Symbol chosen = hint;
+                size_t i = 0;
+                while (taken.count(chosen)) {
+                    chosen = symbols().intern(symbols().name(hint) + std::to_string(i++));
+                }
+                taken.insert(chosen);
+                scope.push_back(chosen);
+                frames.push_back({ node, chosen, true });
+                frames.push_back({ node->left, 0, false });
+                break;
+            }
+            case TermKind::App:
+                frames.push_back({ node, 0, true });
+                frames.push_back({ node->right, 0, false });
+                frames.push_back({ node->left, 0, false });
+                break;
+            }
+            continue;
+        }
+        if (node->kind == TermKind::Lam) {
+            scope.pop_back();
+            taken.erase(frame.chosen);
+            ExprPtr body = results.back();
+            results.pop_back();
+            results.push_back(arena.make<Abstraction>(frame.chosen, body));
+        } else {
+            ExprPtr arg = results.back();
+            results.pop_back();
+            ExprPtr func = results.back();
+            results.pop_back();
+            results.push_back(arena.make<Application>(func, arg));
+        }
+    }
+    return results.back();
+}
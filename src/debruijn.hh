@@ -0,0 +1,191 @@
+#ifndef _DEBRUIJN_HH_
+#define _DEBRUIJN_HH_
+
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+#include "arena.hh"
+#include "expr.hh"
+#include "string.hh"
+
+// De Bruijn-indexed representation used by the reducer. The named AST
+// from the Parser is compiled into Terms before reduction, so the hot
+// path runs on integer shifts with no name comparison, no alpha
+// conversion and no fresh-name search; names come back only in readback
+// for display.
+enum class TermKind { Var, Lam, App };
+
+// Tree sizes combine with saturation: sharing through the cache can
+// make the tree view exponentially larger than the node count, and a
+// capped size still answers every question a scheduler or limiter asks.
+inline long combinedSize(long a, long b) {
+    const long cap = 1L << 56;
+    long sum = a + b + 1;
+    return sum > cap ? cap : sum;
+}
+
+class Term {
+public:
+    // Bound variable: index is the distance to its binder.
+    Term(int index)
+      : kind(TermKind::Var), index(index), freeBound(index + 1),
+        size(1), depth(1), left(nullptr), right(nullptr) {}
+    // Free variable: keeps its source name for readback.
+    Term(Symbol freeName)
+      : kind(TermKind::Var), index(-1), freeBound(0), size(1), depth(1),
+        name(freeName), left(nullptr), right(nullptr) {}
+    // Abstraction: name is only a display hint for readback.
+    Term(Symbol hint, Term* body)
+      : kind(TermKind::Lam), index(-1),
+        freeBound(body->freeBound > 0 ? body->freeBound - 1 : 0),
+        size(combinedSize(body->size, 0)), depth(body->depth + 1),
+        name(hint), left(body), right(nullptr) {}
+    // Application.
+    Term(Term* func, Term* arg)
+      : kind(TermKind::App), index(-1),
+        freeBound(func->freeBound > arg->freeBound ? func->freeBound : arg->freeBound),
+        size(combinedSize(func->size, arg->size)),
+        depth((func->depth > arg->depth ? func->depth : arg->depth) + 1),
+        left(func), right(arg) {}
+
+    TermKind kind;
+    int index;
+    // Number of enclosing binders the term depends on; 0 means no index
+    // escapes, so the term reduces the same way in any context.
+    int freeBound;
+    // Tree size (saturating) and depth, filled at construction since
+    // children always exist first; constant-time reads for the size
+    // limiter, the parallel cutoff and :stats.
+    long size;
+    int depth;
+    Symbol name = 0;
+    Term* left;   // Lam body or App func
+    Term* right;  // App arg
+};
+
+// Hash-consing constructor for Terms: structurally identical requests
+// return the same node, so substitution results share unchanged
+// subtrees and equal terms compare by pointer. Lam display hints are
+// ignored by the key — α-equivalent abstractions share one node. The
+// table lives as long as its arena, typically one evaluation.
+class TermCache {
+public:
+    TermCache(Arena& arena) : arena(arena) {}
+
+    Term* var(int index);
+    Term* freeVar(Symbol name);
+    Term* lam(Symbol hint, Term* body);
+    Term* app(Term* func, Term* arg);
+
+    Arena& arena;
+
+    // Normal forms of closed subterms (freeBound == 0) computed earlier
+    // in this evaluation; hash-consing makes the pointer a sound key.
+    std::unordered_map<const Term*, Term*> normalForms;
+
+    // Reduction budget: at most stepLimit β-contractions, optionally a
+    // wall-clock deadline. Divergent terms then come back partially
+    // reduced with exhausted set instead of hanging the evaluator.
+    long stepLimit = 1000000;
+    long stepsTaken = 0;
+
+    // Largest term the reducer may build (0 = unlimited), the analogue
+    // of fuel for space: growth past the limit stops contraction with
+    // exhausted set instead of swapping the machine.
+    long sizeLimit = 0;
+
+    // Instrumentation for :stats -- plain increments on paths that
+    // already do real work, so the instrumented build is the production
+    // build.
+    long substitutions = 0;
+    long shifts = 0;
+    std::chrono::steady_clock::time_point deadline = {};
+    bool exhausted = false;
+
+    // Account for one β-step; false means the budget is spent and the
+    // engine must stop contracting.
+    bool spendFuel();
+
+    // Per-step trace sink; null (the default) means no tracing, so the
+    // hot path pays one pointer test instead of string building.
+    std::ostream* trace = nullptr;
+
+    // Per-evaluation display hints, keyed by node. The Lam hash-cons key
+    // deliberately excludes the binder hint, so an α-equivalent node
+    // from an earlier query keeps that query's name for the cache's
+    // lifetime; recording the current evaluation's source names here
+    // lets readback render λy.y as λy.y even when the interned node
+    // still says q. The session clears the map when it arms a budget.
+    std::unordered_map<const Term*, Symbol> hints;
+
+    // Record the hint this evaluation wants for a Lam; storing nothing
+    // when it matches the node keeps the map proportional to the
+    // conflicts, not to the term.
+    void noteHint(const Term* term, Symbol hint);
+
+    // The display hint readback should use for this node.
+    Symbol hintFor(const Term* term) const;
+
+    // Whether normalize may short-circuit Church arithmetic through the
+    // native fast path. bench turns it off to measure the generic
+    // engine; everywhere else the answer is the same either way, only
+    // faster.
+    bool nativeArith = true;
+
+    // Reference combinators for the native arithmetic fast path,
+    // compiled on first use; hash-consing makes pointer comparison
+    // against user terms sound within this cache.
+    Term* arithAdd = nullptr;
+    Term* arithMult = nullptr;
+    Term* arithMult3 = nullptr;
+    Term* arithPow = nullptr;
+    Term* arithSucc = nullptr;
+
+    // Arenas and engines taken over from parallel reduction tasks. The
+    // final term references nodes they own, so they must live exactly
+    // as long as this cache.
+    std::vector<std::unique_ptr<Arena>> adoptedArenas;
+    std::vector<std::unique_ptr<TermCache>> adoptedCaches;
+
+private:
+    struct Key {
+        TermKind kind;
+        int index;
+        const Term* left;
+        const Term* right;
+        Symbol name;
+        bool operator==(const Key& other) const {
+            return kind == other.kind && index == other.index &&
+                   left == other.left && right == other.right && name == other.name;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    Term* intern(const Key& key);
+
+    std::unordered_map<Key, Term*, KeyHash> table;
+};
+
+// Compile a parsed named expression into its De Bruijn form.
+Term* compile(ExprPtr expr, TermCache& cache);
+
+// Reduce a term to its normal form under normal-order strategy.
+Term* normalize(Term* term, TermCache& cache);
+
+class ThreadPool;
+
+// Like normalize, but ships one side of each sufficiently large
+// application to the pool once the head is inert, since sibling
+// subtrees reduce independently. Opt-in (:par); small terms fall back
+// to the sequential path.
+Term* normalizeParallel(Term* term, TermCache& cache, ThreadPool& pool);
+
+// Convert a term back into a named expression for display, preferring
+// the cache's per-evaluation hints over the interned binder names.
+ExprPtr readback(Term* term, TermCache& cache);
+
+#endif // !_DEBRUIJN_HH_
@@ -0,0 +1,161 @@
+#include "env.hh"
+
+#include <algorithm>
+#include <vector>
+#include "debruijn.hh"
+
+// Deep-copy an expression into another arena, e.g. between the
+// environment arena and a per-evaluation one. Explicit work stack:
+// bindings can hold arbitrarily deep terms.
+static ExprPtr cloneExpr(ExprPtr expr, Arena& arena) {
+    struct Frame { ExprPtr expr; bool exit; };
+    std::vector<Frame> frames{ { expr, false } };
+    std::vector<ExprPtr> results;
+    while (!frames.empty()) {
+        Frame frame = frames.back();
+        frames.pop_back();
+        ExprPtr node = frame.expr;
+        if (!frame.exit) {
+            switch (node->kind) {
+            case ExprKind::Variable:
+                results.push_back(arena.make<Variable>(asVariable(node)->name));
+                break;
+            case ExprKind::Abstraction:
+                frames.push_back({ node, true });
+                frames.push_back({ asAbstraction(node)->body, false });
+                break;
+            case ExprKind::Application:
+                frames.push_back({ node, true });
+                frames.push_back({ asApplication(node)->arg, false });
+                frames.push_back({ asApplication(node)->func, false });
+                break;
+            }
+            continue;
+        }
+        if (node->kind == ExprKind::Abstraction) {
+            ExprPtr body = results.back();
+            results.pop_back();
+            results.push_back(arena.make<Abstraction>(asAbstraction(node)->param, body));
+        } else {
+            ExprPtr arg = results.back();
+            results.pop_back();
+            ExprPtr func = results.back();
+            results.pop_back();
+            results.push_back(arena.make<Application>(func, arg));
+        }
+    }
+    return results.back();
+}
+
+void Environment::define(Symbol name, ExprPtr source, ExprPtr value) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    Binding binding;
+    binding.source = cloneExpr(source, arena);
+    binding.value = cloneExpr(value, arena);
+    binding.uses = source->occurringNames();
+    binding.fresh = true;
+    binding.revalidating = false;
+    bindings[name] = std::move(binding);
+    // Everything that references this name -- directly or through other
+    // bindings -- now has a stale value.
+    std::vector<Symbol> invalidated{ name };
+    while (!invalidated.empty()) {
+        Symbol changed = invalidated.back();
+        invalidated.pop_back();
+        for (auto& entry : bindings) {
+            if (entry.first == name || !entry.second.fresh) continue;
+            if (std::binary_search(entry.second.uses.begin(), entry.second.uses.end(), changed)) {
+                entry.second.fresh = false;
+                invalidated.push_back(entry.first);
+            }
+        }
+    }
+}
+
+// Rebuild a stale value from its source: expansion pulls in the
+// dependents' current values (recursively revalidating them), then the
+// result is normalized just as evaluate() would.
+ExprPtr Environment::revalidate(Binding& binding) const {
+    binding.revalidating = true;
+    Arena scratch;
+    ExprPtr expanded;
+    try {
+        expanded = expandBindings(binding.source, *this, scratch);
+    } catch (...) {
+        binding.revalidating = false;
+        throw;
+    }
+    binding.revalidating = false;
+    TermCache cache(scratch);
+    Term* reduced = normalize(compile(expanded, cache), cache);
+    binding.value = cloneExpr(readback(reduced, cache), arena);
+    binding.fresh = true;
+    return binding.value;
+}
+
+ExprPtr Environment::lookup(Symbol name) const {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    auto found = bindings.find(name);
+    if (found == bindings.end() || found->second.revalidating) return nullptr;
+    if (!found->second.fresh) return revalidate(found->second);
+    return found->second.value;
+}
+
+// Only variables that are free here may be expanded; binders shadow
+// the environment as usual. Unchanged subtrees come back as-is.
+ExprPtr expandBindings(ExprPtr expr, const Environment& env, Arena& arena) {
+    struct Frame { ExprPtr expr; bool exit; };
+    std::vector<Symbol> scope;
+    std::vector<Frame> frames{ { expr, false } };
+    std::vector<ExprPtr> results;
+    while (!frames.empty()) {
+        Frame frame = frames.back();
+        frames.pop_back();
+        ExprPtr node = frame.expr;
+        if (!frame.exit) {
+            switch (node->kind) {
+            case ExprKind::Variable: {
+                auto var = asVariable(node);
+                bool shadowed = false;
+                for (auto it = scope.rbegin(); it != scope.rend(); ++it) {
+                    if (*it == var->name) {
+                        shadowed = true;
+                        break;
+                    }
+                }
+                ExprPtr bound = shadowed ? nullptr : env.lookup(var->name);
+                results.push_back(bound == nullptr ? node : cloneExpr(bound, arena));
+                break;
+            }
+            case ExprKind::Abstraction:
+                scope.push_back(asAbstraction(node)->param);
+                frames.push_back({ node, true });
+                frames.push_back({ asAbstraction(node)->body, false });
+                break;
+            case ExprKind::Application:
+                frames.push_back({ node, true });
+                frames.push_back({ asApplication(node)->arg, false });
+                frames.push_back({ asApplication(node)->func, false });
+                break;
+            }
+            continue;
+        }
+        if (node->kind == ExprKind::Abstraction) {
+            scope.pop_back();
+            ExprPtr body = results.back();
+            results.pop_back();
+            results.push_back(body == asAbstraction(node)->body
+                                  ? node
+                                  : arena.make<Abstraction>(asAbstraction(node)->param, body));
+        } else {
+            ExprPtr arg = results.back();
+            results.pop_back();
+            ExprPtr func = results.back();
+            results.pop_back();
+            results.push_back(func == asApplication(node)->func && arg == asApplication(node)->arg
+                                  ? node
+                                  : arena.make<Application>(func, arg));
+        }
+    }
+    return results.back();
+}
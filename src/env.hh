@@ -0,0 +1,64 @@
+#ifndef _ENV_HH_
+#define _ENV_HH_
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "arena.hh"
+#include "expr.hh"
+#include "string.hh"
+#include "symbol.hh"
+
+// One environment entry. `source` is the definition as written
+// (pre-expansion) and `value` its normalized form; when a binding this
+// entry references is redefined, the value goes stale and is
+// re-normalized from source on next use.
+struct Binding {
+    ExprPtr source;
+    ExprPtr value;
+    // Names the source references -- its occurring-name set, which
+    // over-approximates the free ones; a spurious dependency only costs
+    // a re-normalization that reproduces the same value.
+    std::vector<Symbol> uses;
+    bool fresh;
+    // Guards against self-referential definitions looping the
+    // revalidator; an in-progress name reads as unbound.
+    bool revalidating;
+};
+
+// Global let-binding environment. Names map to pre-parsed (and
+// pre-reduced) ASTs held in the environment's own arena, so each use of
+// a binding is an O(1) lookup plus a clone instead of re-lexing and
+// re-parsing source text. Redefining a name transitively marks every
+// dependent entry stale; stale values are rebuilt lazily, so tweaking
+// one prelude definition touches only what actually used it.
+class Environment {
+public:
+    // Store a definition under `name`, deep-copying both forms into the
+    // environment arena; a later definition of the same name replaces
+    // the old one and invalidates its dependents.
+    void define(Symbol name, ExprPtr source, ExprPtr value);
+
+    // The bound normalized expression, or null when the name is
+    // unbound. Re-normalizes the entry first if it is stale.
+    ExprPtr lookup(Symbol name) const;
+
+    // Every binding, e.g. for serialization.
+    const std::unordered_map<Symbol, Binding>& all() const { return bindings; }
+
+private:
+    ExprPtr revalidate(Binding& binding) const;
+
+    // Revalidation re-enters lookup through expansion, and batch
+    // workers may expand concurrently.
+    mutable std::recursive_mutex lock;
+    mutable Arena arena;
+    mutable std::unordered_map<Symbol, Binding> bindings;
+};
+
+// Replace every free variable that names a binding with a copy of the
+// bound expression. Unchanged subtrees are returned as-is.
+ExprPtr expandBindings(ExprPtr expr, const Environment& env, Arena& arena);
+
+#endif // !_ENV_HH_
@@ -0,0 +1,138 @@
+#include "expr.hh"
+
+#include <algorithm>
+#include <vector>
+
+void Expr::stream(std::ostream& out, size_t maxBytes, int maxDepth) const {
+    struct Item { ExprPtr expr; char literal; int depth; };
+    std::vector<Item> stack{ { const_cast<ExprPtr>(this), 0, 0 } };
+    size_t written = 0;
+    auto emit = [&](const char* bytes, size_t count) {
+        out.write(bytes, count);
+        written += count;
+    };
+    while (!stack.empty()) {
+        Item item = stack.back();
+        stack.pop_back();
+        if (item.expr == nullptr) {
+            emit(&item.literal, 1);
+            continue;
+        }
+        if (maxBytes != 0 && written >= maxBytes) {
+            out.write("...", 3);
+            return;
+        }
+        if (maxDepth != 0 && item.depth > maxDepth) {
+            emit("...", 3);
+            continue;
+        }
+        switch (item.expr->kind) {
+        case ExprKind::Variable: {
+            const std::string& name = symbols().utf8Name(asVariable(item.expr)->name);
+            emit(name.data(), name.size());
+            break;
+        }
+        case ExprKind::Abstraction: {
+            const std::string& name = symbols().utf8Name(asAbstraction(item.expr)->param);
+            emit("λ", 2);
+            emit(name.data(), name.size());
+            emit(".", 1);
+            stack.push_back({ asAbstraction(item.expr)->body, 0, item.depth + 1 });
+            break;
+        }
+        case ExprKind::Application:
+            emit("(", 1);
+            stack.push_back({ nullptr, ')', item.depth });
+            stack.push_back({ asApplication(item.expr)->arg, 0, item.depth + 1 });
+            stack.push_back({ nullptr, ' ', item.depth });
+            stack.push_back({ asApplication(item.expr)->func, 0, item.depth + 1 });
+            break;
+        }
+    }
+}
+
+const std::vector<Symbol>& Expr::occurringNames() const {
+    if (occurringCached) return occurringCache;
+    std::vector<ExprPtr> stack{ const_cast<ExprPtr>(this) };
+    while (!stack.empty()) {
+        ExprPtr node = stack.back();
+        stack.pop_back();
+        switch (node->kind) {
+        case ExprKind::Variable:
+            occurringCache.push_back(asVariable(node)->name);
+            break;
+        case ExprKind::Abstraction:
+            occurringCache.push_back(asAbstraction(node)->param);
+            stack.push_back(asAbstraction(node)->body);
+            break;
+        case ExprKind::Application:
+            stack.push_back(asApplication(node)->arg);
+            stack.push_back(asApplication(node)->func);
+            break;
+        }
+    }
+    std::sort(occurringCache.begin(), occurringCache.end());
+    occurringCache.erase(std::unique(occurringCache.begin(), occurringCache.end()),
+                         occurringCache.end());
+    occurringCached = true;
+    return occurringCache;
+}
+
+// Work items are either a node to render or a literal byte to emit
+// once the subtree before it is done.
+void Expr::print(std::string& out) const {
+    struct Item { ExprPtr expr; char literal; };
+    std::vector<Item> stack{ { const_cast<ExprPtr>(this), 0 } };
+    while (!stack.empty()) {
+        Item item = stack.back();
+        stack.pop_back();
+        if (item.expr == nullptr) {
+            out += item.literal;
+            continue;
+        }
+        switch (item.expr->kind) {
+        case ExprKind::Variable:
+            out += symbols().utf8Name(asVariable(item.expr)->name);
+            break;
+        case ExprKind::Abstraction:
+            out += "λ";
+            out += symbols().utf8Name(asAbstraction(item.expr)->param);
+            out += '.';
+            stack.push_back({ asAbstraction(item.expr)->body, 0 });
+            break;
+        case ExprKind::Application:
+            out += '(';
+            stack.push_back({ nullptr, ')' });
+            stack.push_back({ asApplication(item.expr)->arg, 0 });
+            stack.push_back({ nullptr, ' ' });
+            stack.push_back({ asApplication(item.expr)->func, 0 });
+            break;
+        }
+    }
+}
+
+size_t Expr::renderedSize() const {
+    size_t size = 0;
+    std::vector<ExprPtr> stack{ const_cast<ExprPtr>(this) };
+    while (!stack.empty()) {
+        ExprPtr node = stack.back();
+        stack.pop_back();
+        switch (node->kind) {
+        case ExprKind::Variable:
+            size += symbols().utf8Name(asVariable(node)->name).size();
+            break;
+        case ExprKind::Abstraction:
+            // "λ" is two UTF-8 bytes, plus the dot.
+            size += 2 + symbols().utf8Name(asAbstraction(node)->param).size() + 1;
+            stack.push_back(asAbstraction(node)->body);
+            break;
+        case ExprKind::Application:
+            size += 3;
+            stack.push_back(asApplication(node)->arg);
+            stack.push_back(asApplication(node)->func);
+            break;
+        }
+    }
+    return size;
+}
+
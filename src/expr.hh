@@ -0,0 +1,85 @@
+#ifndef _EXPR_HH_
+#define _EXPR_HH_
+
+#include <ostream>
+#include <vector>
+#include "arena.hh"
+#include "string.hh"
+#include "symbol.hh"
+
+// Every node carries its kind so traversals can dispatch with one
+// switch instead of a chain of dynamic_pointer_cast probes.
+enum class ExprKind { Variable, Abstraction, Application };
+
+class Expr {
+public:
+    Expr(ExprKind kind) : kind(kind) {}
+    virtual ~Expr() = default;
+    // Append the rendering to an output buffer; building in place keeps
+    // printing linear where the old operator+ chains were quadratic.
+    // Iterative over an explicit stack, so arbitrarily deep results
+    // print without overflowing the C stack.
+    void print(std::string& out) const;
+    // Rendered size in bytes, used to pre-size the buffer.
+    size_t renderedSize() const;
+    // Write the rendering straight to an ostream without materializing
+    // it, eliding with "..." past maxBytes of output or maxDepth levels
+    // of nesting (0 disables either limit). Giant normal forms would
+    // otherwise double peak RSS right at the end of evaluation.
+    void stream(std::ostream& out, size_t maxBytes = 0, int maxDepth = 0) const;
+    String toString() const {
+        std::string out;
+        out.reserve(renderedSize());
+        print(out);
+        return String(out);
+    }
+    // Every name occurring in this subtree, free or binding, sorted for
+    // binary search. Computed on first use; nodes are immutable, so the
+    // cache never invalidates. The environment's dependency tracking
+    // treats binders as occurrences too, deliberately erring broad.
+    const std::vector<Symbol>& occurringNames() const;
+    ExprKind kind;
+    mutable std::vector<Symbol> occurringCache;
+    mutable bool occurringCached = false;
+};
+
+// Nodes live in a per-evaluation Arena and are referenced by plain
+// pointers; the whole tree is released when evaluate() returns.
+using ExprPtr = Expr*;
+
+class Variable : public Expr {
+public:
+    Variable(Symbol name) : Expr(ExprKind::Variable), name(name) {}
+    Symbol name;
+};
+
+class Abstraction : public Expr {
+public:
+    Abstraction(Symbol param, ExprPtr body)
+      : Expr(ExprKind::Abstraction), param(param), body(body) {}
+    Symbol param;
+    ExprPtr body;
+};
+
+class Application : public Expr {
+public:
+    Application(ExprPtr func, ExprPtr arg)
+      : Expr(ExprKind::Application), func(func), arg(arg) {}
+    ExprPtr func;
+    ExprPtr arg;
+};
+
+// The kind tag makes these downcasts safe without RTTI.
+inline Variable* asVariable(ExprPtr expr) {
+    return static_cast<Variable*>(expr);
+}
+
+inline Abstraction* asAbstraction(ExprPtr expr) {
+    return static_cast<Abstraction*>(expr);
+}
+
+inline Application* asApplication(ExprPtr expr) {
+    return static_cast<Application*>(expr);
+}
+
+#endif // !_EXPR_HH_
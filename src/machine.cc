@@ -0,0 +1,203 @@
+#include "machine.hh"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Value;
+
+struct VEnv;
+
+// Delayed evaluation of a term in an environment; `forced` memoizes the
+// result, so shared arguments are evaluated at most once (call-by-need
+// graph reduction rather than plain call-by-name).
+struct Thunk {
+    Thunk(Term* term, VEnv* env) : term(term), env(env), forced(nullptr) {}
+    explicit Thunk(Value* value) : term(nullptr), env(nullptr), forced(value) {}
+    Term* term;
+    VEnv* env;
+    Value* forced;
+};
+
+// Environments are persistent linked lists: extending one costs a
+// single arena node and closures share tails, where substitution had
+// to copy the whole body.
+struct VEnv {
+    VEnv(Thunk* head, VEnv* next) : head(head), next(next) {}
+    Thunk* head;
+    VEnv* next;
+};
+
+enum class ValueKind { Closure, Level, Free, Apply };
+
+struct Value {
+    // Closure: a Lam body waiting for its argument.
+    Value(Term* body, VEnv* env, Symbol hint)
+      : kind(ValueKind::Closure), body(body), env(env), name(hint),
+        level(0), func(nullptr), arg(nullptr) {}
+    // Fresh variable introduced by quote at binder depth `level`.
+    explicit Value(int level)
+      : kind(ValueKind::Level), body(nullptr), env(nullptr), name(0),
+        level(level), func(nullptr), arg(nullptr) {}
+    // Free variable keeping its source name.
+    explicit Value(Symbol name)
+      : kind(ValueKind::Free), body(nullptr), env(nullptr), name(name),
+        level(0), func(nullptr), arg(nullptr) {}
+    // Neutral application: an inert head applied to a pending argument.
+    Value(Value* func, Thunk* arg)
+      : kind(ValueKind::Apply), body(nullptr), env(nullptr), name(0),
+        level(0), func(func), arg(arg) {}
+
+    ValueKind kind;
+    Term* body;
+    VEnv* env;
+    Symbol name;
+    int level;
+    Value* func;
+    Thunk* arg;
+};
+
+} // namespace
+
+// Evaluate with an explicit continuation stack -- like every traversal
+// in debruijn.cc -- so term depth, spine length and chains of unforced
+// thunks are all bounded by memory instead of the C stack. An Apply
+// frame holds the pending argument of an application whose head is
+// still evaluating; a Memo frame fills in a thunk once the value it
+// delayed comes back.
+static Value* eval(Term* term, VEnv* env, TermCache& cache) {
+    enum class FrameKind { Apply, Memo };
+    struct Frame { FrameKind kind; Thunk* thunk; };
+    std::vector<Frame> frames;
+    while (true) {
+        // Descend until the current term yields a value.
+        Value* result = nullptr;
+        while (result == nullptr) {
+            switch (term->kind) {
+            case TermKind::Var: {
+                if (term->index < 0) {
+                    result = cache.arena.make<Value>(term->name);
+                    break;
+                }
+                VEnv* walk = env;
+                for (int i = 0; i < term->index; ++i) walk = walk->next;
+                Thunk* thunk = walk->head;
+                if (thunk->forced != nullptr) {
+                    result = thunk->forced;
+                    break;
+                }
+                frames.push_back({ FrameKind::Memo, thunk });
+                term = thunk->term;
+                env = thunk->env;
+                break;
+            }
+            case TermKind::Lam:
+                result = cache.arena.make<Value>(term->left, env, cache.hintFor(term));
+                break;
+            case TermKind::App:
+                frames.push_back({ FrameKind::Apply,
+                                   cache.arena.make<Thunk>(term->right, env) });
+                term = term->left;
+                break;
+            }
+        }
+        // Hand the value back through the continuations; a closure
+        // meeting its argument switches back to descending.
+        bool descending = false;
+        while (!frames.empty() && !descending) {
+            Frame frame = frames.back();
+            frames.pop_back();
+            if (frame.kind == FrameKind::Memo) {
+                frame.thunk->forced = result;
+                continue;
+            }
+            if (result->kind == ValueKind::Closure) {
+                // β-contraction is one environment extension; the fuel
+                // budget still applies, but an exhausted machine has no
+                // partial term to hand back, so it reports instead.
+                if (!cache.spendFuel()) {
+                    cache.exhausted = true;
+                    throw std::runtime_error(
+                        "machine engine out of fuel after " +
+                        std::to_string(cache.stepsTaken) + " steps");
+                }
+                env = cache.arena.make<VEnv>(frame.thunk, result->env);
+                term = result->body;
+                descending = true;
+                continue;
+            }
+            result = cache.arena.make<Value>(result, frame.thunk);
+        }
+        if (!descending) return result;
+    }
+}
+
+static Value* force(Thunk* thunk, TermCache& cache) {
+    if (thunk->forced == nullptr) {
+        thunk->forced = eval(thunk->term, thunk->env, cache);
+    }
+    return thunk->forced;
+}
+
+// Read the normal form back out of the value graph: closures are
+// applied to fresh variables, levels convert to indices relative to the
+// current binder depth, and terms are rebuilt through the cache. Enter
+// frames run eval wherever a subvalue is still delayed; exit frames
+// assemble terms from the result stack, so the depth of the normal
+// form never touches the C stack either.
+static Term* quote(Value* value, TermCache& cache) {
+    struct Frame { Value* value; int level; bool exit; };
+    std::vector<Frame> frames{ { value, 0, false } };
+    std::vector<Term*> results;
+    while (!frames.empty()) {
+        Frame frame = frames.back();
+        frames.pop_back();
+        Value* node = frame.value;
+        if (!frame.exit) {
+            switch (node->kind) {
+            case ValueKind::Closure: {
+                Thunk* fresh = cache.arena.make<Thunk>(cache.arena.make<Value>(frame.level));
+                VEnv* env = cache.arena.make<VEnv>(fresh, node->env);
+                Value* body = eval(node->body, env, cache);
+                frames.push_back({ node, frame.level, true });
+                frames.push_back({ body, frame.level + 1, false });
+                break;
+            }
+            case ValueKind::Level:
+                results.push_back(cache.var(frame.level - node->level - 1));
+                break;
+            case ValueKind::Free:
+                results.push_back(cache.freeVar(node->name));
+                break;
+            case ValueKind::Apply:
+                frames.push_back({ node, frame.level, true });
+                frames.push_back({ force(node->arg, cache), frame.level, false });
+                frames.push_back({ node->func, frame.level, false });
+                break;
+            }
+            continue;
+        }
+        if (node->kind == ValueKind::Closure) {
+            Term* body = results.back();
+            results.pop_back();
+            // The interned node may carry another query's binder name;
+            // record this evaluation's so readback prefers it.
+            Term* made = cache.lam(node->name, body);
+            cache.noteHint(made, node->name);
+            results.push_back(made);
+        } else {
+            Term* arg = results.back();
+            results.pop_back();
+            Term* func = results.back();
+            results.pop_back();
+            results.push_back(cache.app(func, arg));
+        }
+    }
+    return results.back();
+}
+
+Term* machineNormalize(Term* term, TermCache& cache) {
+    return quote(eval(term, nullptr, cache), cache);
+}
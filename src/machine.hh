@@ -0,0 +1,15 @@
+#ifndef _MACHINE_HH_
+#define _MACHINE_HH_
+
+#include "debruijn.hh"
+
+// Alternative evaluation backend (:engine machine): a Krivine-style
+// environment machine. Instead of rewriting the term at every β-step,
+// eval builds closures over persistent environments with call-by-need
+// thunks -- no substitution, no shifting, no tree copies -- and the
+// normal form is read back from the value graph through the same
+// TermCache, so readback and printing are unchanged. Values live in
+// the cache's arena and die with it.
+Term* machineNormalize(Term* term, TermCache& cache);
+
+#endif // !_MACHINE_HH_
@@ -1,386 +1,695 @@
 #include <iostream>
-#include <sstream>
+#include <fstream>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
 #include <vector>
 #include <algorithm>
 #include <readline/readline.h>
 #include <readline/history.h>
+#include "arena.hh"
+#include "debruijn.hh"
+#include "env.hh"
+#include "expr.hh"
+#include "machine.hh"
+#include "parser.hh"
+#include "pool.hh"
+#include "store.hh"
 #include "string.hh"
 
-enum class TokenType { VARIABLE, LAMBDA, DOT, LPAREN, RPAREN, END };
+// Perf counters for one evaluation, shown by :stats and emitted as
+// JSON lines in batch mode under --stats-json.
+struct Stats {
+    long steps = 0;
+    long substitutions = 0;
+    long shifts = 0;
+    size_t nodes = 0;
+    long resultSize = 0;
+    int resultDepth = 0;
+    double lexParseMs = 0;
+    double expandMs = 0;
+    double compileMs = 0;
+    double reduceMs = 0;
+    double printMs = 0;
+};
 
-struct Token {
-    TokenType type;
-    Char value;
-    Token(TokenType t, const Char& v = "") : type(t), value(v) {}
+struct Result {
+    String value;
+    bool isOk;
+    Stats stats;
 };
 
-class Lexer {
-public:
-    Lexer(const String& input) : input(input), position(0) {}
-
-    std::vector<Token> tokenize() {
-        std::vector<Token> tokens;
-        while (position < input.length()) {
-            skipWhitespace();
-            if (position >= input.length()) break;
-
-            Char current = input[position++];
-            if (current == "λ") {
-                tokens.emplace_back(TokenType::LAMBDA);
-            } else if (current == ".") {
-                tokens.emplace_back(TokenType::DOT);
-            } else if (current == "(") {
-                tokens.emplace_back(TokenType::LPAREN);
-            } else if (current == ")") {
-                tokens.emplace_back(TokenType::RPAREN);
-            } else if (!isspace(current.toCodepoint()) && !isdigit(current.toCodepoint())) {
-                tokens.emplace_back(TokenType::VARIABLE, current);
-            } else {
-                throw std::runtime_error("Unexpected character encountered");
-            }
-        }
-        tokens.emplace_back(TokenType::END); // Add an END token at the end
-        return tokens;
-    }
+// Batch mode only: emit one JSON line of counters per evaluated
+// expression on stderr, keeping stdout parseable as results.
+bool statsJsonSetting = false;
+
+std::string statsJson(const Stats& stats) {
+    std::ostringstream out;
+    out << "{\"steps\":" << stats.steps
+        << ",\"substitutions\":" << stats.substitutions
+        << ",\"shifts\":" << stats.shifts
+        << ",\"nodes\":" << stats.nodes
+        << ",\"result_size\":" << stats.resultSize
+        << ",\"result_depth\":" << stats.resultDepth
+        << ",\"lex_parse_ms\":" << stats.lexParseMs
+        << ",\"expand_ms\":" << stats.expandMs
+        << ",\"compile_ms\":" << stats.compileMs
+        << ",\"reduce_ms\":" << stats.reduceMs
+        << ",\"print_ms\":" << stats.printMs << "}";
+    return out.str();
+}
 
-private:
-    String input;
-    size_t position;
+static ThreadPool& reductionPool() {
+    static ThreadPool pool;
+    return pool;
+}
 
-    void skipWhitespace() {
-        while (position < input.length() && isspace(input[position].toCodepoint())) {
-            ++position;
-        }
-    }
+struct BindingEntry {
+    String name;
+    String expr;
 };
 
-class Expr {
-public:
-    virtual ~Expr() = default;
-    virtual String toString() const = 0;
+enum class InputType {
+    Expression,
+    Binding, InvalidBinding,
+    Assertion, InvalidAssertion,
 };
 
-using ExprPtr = std::shared_ptr<Expr>;
+std::string trim(const std::string& str) {
+    std::string s = str;
+    s.erase(0, std::find_if(s.begin(), s.end(), [](unsigned char ch) {
+        return !std::isspace(ch);
+    }) - s.begin());
+    s.erase(std::find_if(s.rbegin(), s.rend(), [](unsigned char ch) {
+        return !std::isspace(ch);
+    }).base() - s.begin(), s.length());
+    std::replace(s.begin(), s.end(), ' ', '-');
+    return s;
+}
 
-class Variable : public Expr {
-public:
-    Variable(const String& name) : name(name) {}
-    String toString() const override {
-        return name;
+InputType processBinding(const std::string& input, BindingEntry& entry) {
+    std::string trimmedInput = input.substr(input.find_first_not_of(' '));
+    if (trimmedInput.substr(0, 4) != "let ") {
+        return InputType::Expression;
     }
-    String name;
-};
-
-class Abstraction : public Expr {
-public:
-    Abstraction(const String& param, ExprPtr body) : param(param), body(body) {}
-    String toString() const override {
-        return "λ" + param + "." + body->toString();
+    size_t wordStart = 4;
+    size_t wordEnd = trimmedInput.find('=', wordStart);
+    if (wordEnd == std::string::npos) {
+        return InputType::InvalidBinding;
     }
-    String param;
-    ExprPtr body;
-};
+    entry.name = trim(trimmedInput.substr(wordStart, wordEnd - wordStart));
+    entry.expr = trimmedInput.substr(wordEnd + 1);
+    return InputType::Binding;
+}
 
-class Application : public Expr {
-public:
-    Application(ExprPtr func, ExprPtr arg) : func(func), arg(arg) {}
-    String toString() const override {
-        return "(" + func->toString() + " " + arg->toString() + ")";
-    }
-    ExprPtr func;
-    ExprPtr arg;
+
+struct AssertionEntry {
+    String lhs;
+    String rhs;
 };
 
-class Parser {
-public:
-    Parser(const std::vector<Token>& tokens) 
-      : tokens(tokens), currentPosition(0), currentToken(tokens[currentPosition]) {
+InputType processAssertion(const std::string& input, AssertionEntry& entry) {
+    size_t first = input.find_first_not_of(" \t");
+    if (first == std::string::npos || input.compare(first, 7, "assert ") != 0) {
+        return InputType::Expression;
     }
-
-    ExprPtr parse() {
-        return parseExpression();
+    size_t separator = input.find("==", first + 7);
+    if (separator == std::string::npos) {
+        return InputType::InvalidAssertion;
     }
+    entry.lhs = String(input.substr(first + 7, separator - first - 7));
+    entry.rhs = String(input.substr(separator + 2));
+    return InputType::Assertion;
+}
 
-private:
-    std::vector<Token> tokens;
-    size_t currentPosition;
-    Token currentToken;
+// Everything one line of input can see or change: the environment, the
+// warm arena with its hash-cons table and normal-form memo, the
+// adjustable limits, and the counters :stats reads back. Evaluations on
+// the session reuse the warm caches, so a stream of related queries
+// against one prelude hits normal forms memoized by earlier queries
+// instead of recomputing them from scratch; :reset drops the lot.
+struct Session {
+    Session() { reset(); }
+
+    std::unique_ptr<Environment> env;
+
+    // The warm arena and cache shared by every evaluation on this
+    // session. Nothing is freed between expressions -- that is the
+    // point -- so :reset is the pressure valve for long sessions.
+    std::unique_ptr<Arena> arena;
+    std::unique_ptr<TermCache> cache;
+
+    // Reusable parse pipeline: the lexer/parser pair is rebound to each
+    // new source line, keeping the parser's context-stack capacity warm
+    // instead of reallocating it per expression.
+    Lexer lexer;
+    Parser parser;
+
+    // Counters from the most recent evaluation; :stats reads them back.
+    Stats lastStats;
+
+    // Evaluation limits, adjustable with :fuel, :timeout and :maxsize.
+    // The size limit (0 = off) aborts a reduction whose term outgrows
+    // the budget -- exponential blowups are caught by the first
+    // offending contraction instead of after a million cheap steps.
+    long stepLimit = 1000000;
+    long timeoutMillis = 0;
+    long maxSize = 0;
+
+    // Per-step tracing is opt-in (:trace on); the default stays silent
+    // so throughput never pays for diagnostics.
+    bool trace = false;
+
+    // Parallel reduction of independent subtrees inside one term is
+    // opt-in (:par on); the pool is shared across evaluations and only
+    // built the first time it is needed.
+    bool parallel = false;
+
+    // Which reduction backend evaluates expressions (:engine
+    // subst|machine): the default tree-rewriting normalizer, or the
+    // environment machine that avoids substitution entirely.
+    bool machine = false;
+
+    // Output limits for results (:print): elide with "..." past this
+    // many bytes or this nesting depth; 0 disables a limit. :print full
+    // clears both, so giant normal forms never hold an interactive
+    // session hostage unless asked for.
+    size_t printLimit = 100000;
+    int printDepth = 0;
+
+    // Drop the environment and every warm cache; limits survive, since
+    // :reset is about memory and staleness, not configuration.
+    void reset() {
+        env.reset(new Environment());
+        arena.reset(new Arena());
+        cache.reset(new TermCache(*arena));
+        lastStats = Stats{};
+    }
 
-    Token nextToken() {
-        if (currentPosition < tokens.size() - 1) { // Ensure position is with bounds
-            currentToken = tokens[++currentPosition];
+    // Render a result honoring the :print limits; with no limits set,
+    // the exact pre-sized builder path is used.
+    String renderResult(ExprPtr expr) {
+        if (printLimit == 0 && printDepth == 0) {
+            return expr->toString();
         }
-        return currentToken;
+        std::ostringstream out;
+        expr->stream(out, printLimit, printDepth);
+        return String(out.str());
     }
 
-    ExprPtr parseExpression() {
-        if (currentToken.type == TokenType::LAMBDA) {
-            nextToken(); // skip LAMBDA
-
-            // To collect all parameters.
-            std::vector<String> parameters;
-            while (currentToken.type == TokenType::VARIABLE) {
-                parameters.push_back(currentToken.value);
-                nextToken(); // skip VARIABLE
-            }
-
-            if (currentToken.type != TokenType::DOT) {
-                throw std::runtime_error("Expected '.' after lambda parameters");
-            }
-            nextToken(); // skip DOT
-
-            ExprPtr body = parseExpression();
+    // Arm the per-evaluation budget on a cache while keeping its memo
+    // and hash-cons table warm from earlier expressions.
+    void armBudget(TermCache& target) {
+        target.stepLimit = stepLimit;
+        target.sizeLimit = maxSize;
+        target.stepsTaken = 0;
+        target.exhausted = false;
+        // Display hints are per-evaluation; the memo and hash-cons
+        // table stay warm, but names should come from the expression
+        // being evaluated now, not whichever query interned the node.
+        target.hints.clear();
+        target.deadline = {};
+        if (timeoutMillis > 0) {
+            target.deadline = std::chrono::steady_clock::now() +
+                              std::chrono::milliseconds(timeoutMillis);
+        }
+    }
 
-            // Multi-parameters lambda may be considered as nested single-parameter lambda
-            for (auto it = parameters.rbegin(); it != parameters.rend(); ++it) {
-                body = std::make_shared<Abstraction>(*it, body);
-            }
+    Result evaluate(const String& input, const String* defineAs = nullptr,
+                    bool warm = true);
+    Result evaluateAssertion(const AssertionEntry& entry, bool warm = true);
+    Result dispatchExpression(const String& input, bool warm = true);
+    String handleCommand(const std::string& input);
+    String interpret(const String& input);
+};
 
-            return body;
+// The one session this process runs; readline callbacks have no
+// argument slot to pass it through, so it lives at namespace scope.
+Session session;
+
+// Evaluate and β-Reduce the source expression. When defineAs is given,
+// the reduced expression is also stored in the environment under that
+// name, pre-normalized so later uses start from the value. Batch
+// workers pass warm = false: the shared caches are not thread-safe, and
+// fan-out already gets its parallelism across lines.
+Result Session::evaluate(const String& input, const String* defineAs, bool warm) {
+    // Per-phase wall time; a microsecond clock read between phases is
+    // noise next to the phases themselves.
+    auto now = [] { return std::chrono::steady_clock::now(); };
+    auto millisSince = [&](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(now() - start)
+                   .count() / 1000.0;
+    };
+    Stats stats;
+    // Selected outside the try so the error path below clears trace on
+    // the cache this evaluation actually used; a cold worker must not
+    // reach over to the session's shared cache.
+    Lexer localLexer;
+    Parser localParser;
+    Arena localArena;
+    TermCache localCache(localArena);
+    Lexer& lexer = warm ? this->lexer : localLexer;
+    Parser& parser = warm ? this->parser : localParser;
+    Arena& arena = warm ? *this->arena : localArena;
+    TermCache& cache = warm ? *this->cache : localCache;
+    try {
+        std::string source = input.toUTF8();
+        lexer.reset(source);
+        parser.reset(lexer, arena);
+        armBudget(cache);
+        // The warm cache outlives this call, so counters report deltas.
+        long substBase = cache.substitutions;
+        long shiftBase = cache.shifts;
+        size_t nodeBase = arena.objects;
+        // Trace lines are batched here and written once, so a long
+        // reduction does not pay a flush per step.
+        std::ostringstream traceBuffer;
+        cache.trace = trace ? &traceBuffer : nullptr;
+        auto phase = now();
+        ExprPtr parsed = parser.parse();
+        stats.lexParseMs = millisSince(phase);
+        phase = now();
+        ExprPtr expression = expandBindings(parsed, *env, arena);
+        stats.expandMs = millisSince(phase);
+        phase = now();
+        Term* compiled = compile(expression, cache);
+        stats.compileMs = millisSince(phase);
+        phase = now();
+        // Tracing stays on the sequential substitution engine so step
+        // output keeps its order.
+        Term* reduced;
+        if (machine && !trace) {
+            reduced = machineNormalize(compiled, cache);
+        } else if (parallel && !trace) {
+            reduced = normalizeParallel(compiled, cache, reductionPool());
         } else {
-            return parseApplication();
+            reduced = normalize(compiled, cache);
         }
-    }
-
-    ExprPtr parseApplication() {
-        ExprPtr expr = parseTerm();
-        while (currentToken.type == TokenType::VARIABLE || currentToken.type == TokenType::LPAREN) {
-            ExprPtr right = parseTerm();
-            expr = std::make_shared<Application>(expr, right);
+        stats.reduceMs = millisSince(phase);
+        phase = now();
+        if (defineAs != nullptr && !cache.exhausted) {
+            // The unexpanded form is kept alongside the value so the
+            // binding can be re-normalized if something it uses is
+            // redefined.
+            env->define(symbols().intern(*defineAs), parsed, readback(reduced, cache));
         }
-        return expr;
-    }
-
-    ExprPtr parseTerm() {
-        if (currentToken.type == TokenType::VARIABLE) {
-            String varName = currentToken.value;
-            nextToken(); // skip VARIABLE
-            return std::make_shared<Variable>(varName);
-        } else if (currentToken.type == TokenType::LPAREN) {
-            nextToken(); // skip LPAREN
-            ExprPtr expr = parseExpression();
-            if (currentToken.type != TokenType::RPAREN) {
-                throw std::runtime_error("Expected closing parenthesis");
-            }
-            nextToken(); // skip RPAREN
-            return expr;
-        } else {
-            throw std::runtime_error("Unexpected term");
+        String rendered = renderResult(readback(reduced, cache));
+        stats.printMs = millisSince(phase);
+        stats.steps = cache.stepsTaken;
+        stats.substitutions = cache.substitutions - substBase;
+        stats.shifts = cache.shifts - shiftBase;
+        stats.nodes = arena.objects - nodeBase;
+        stats.resultSize = reduced->size;
+        stats.resultDepth = reduced->depth;
+        cache.trace = nullptr;
+        if (cache.exhausted) {
+            if (trace) std::cout << traceBuffer.str();
+            return { rendered +
+                     String(" ⚠ not normalized after " + std::to_string(cache.stepsTaken) + " steps"),
+                     true, stats };
+        }
+        if (trace) {
+            traceBuffer << "done.\n";
+            std::cout << traceBuffer.str();
         }
+        return { rendered, true, stats };
+    } catch (const std::exception& e) {
+        cache.trace = nullptr;
+        return { String("Error: ") + e.what(), false, stats };
     }
-};
-
+}
 
-// Check if a variable occurs in expression.
-bool occursIn(const String& varName, ExprPtr expr) {
-    if (auto var = std::dynamic_pointer_cast<Variable>(expr)) {
-        return var->name == varName;
-    } else if (auto abstraction = std::dynamic_pointer_cast<Abstraction>(expr)) {
-        return abstraction->param == varName || occursIn(varName, abstraction->body);
-    } else if (auto application = std::dynamic_pointer_cast<Application>(expr)) {
-        return occursIn(varName, application->func) || occursIn(varName, application->arg);
+// assert e1 == e2: normalize both sides in one cache and compare the
+// resulting pointers. Hash-consing ignores binder display hints, so
+// α-equivalent normal forms are literally the same node -- no string
+// rendering, no name-sensitive diffing.
+Result Session::evaluateAssertion(const AssertionEntry& entry, bool warm) {
+    Stats stats;
+    try {
+        Lexer localLexer;
+        Parser localParser;
+        Arena localArena;
+        TermCache localCache(localArena);
+        Lexer& lexer = warm ? this->lexer : localLexer;
+        Parser& parser = warm ? this->parser : localParser;
+        Arena& arena = warm ? *this->arena : localArena;
+        TermCache& cache = warm ? *this->cache : localCache;
+        armBudget(cache);
+        long substBase = cache.substitutions;
+        long shiftBase = cache.shifts;
+        size_t nodeBase = arena.objects;
+        auto compileSide = [&](const String& text) {
+            std::string source = text.toUTF8();
+            lexer.reset(source);
+            parser.reset(lexer, arena);
+            return compile(expandBindings(parser.parse(), *env, arena), cache);
+        };
+        Term* lhs = normalize(compileSide(entry.lhs), cache);
+        Term* rhs = normalize(compileSide(entry.rhs), cache);
+        stats.steps = cache.stepsTaken;
+        stats.substitutions = cache.substitutions - substBase;
+        stats.shifts = cache.shifts - shiftBase;
+        stats.nodes = arena.objects - nodeBase;
+        if (cache.exhausted) {
+            return { String("⚠ assertion undecided after " +
+                            std::to_string(cache.stepsTaken) + " steps"),
+                     false, stats };
+        }
+        if (lhs == rhs) {
+            return { "✓ assertion holds", true, stats };
+        }
+        return { "✗ assertion failed: " + renderResult(readback(lhs, cache)) +
+                 " ≠ " + renderResult(readback(rhs, cache)),
+                 false, stats };
+    } catch (const std::exception& e) {
+        return { String("Error: ") + e.what(), false, stats };
     }
-    return false;
 }
 
-// Rename variables to avoid from naming conflict.
-String freshName(const String& base, ExprPtr context) {
-    String newName = base;
-    size_t i = 0;
-    while (occursIn(newName, context)) {
-        newName = base + std::to_string(i++);
+// Expressions and assertions share the read-only evaluation path, so
+// batch workers may run either.
+Result Session::dispatchExpression(const String& input, bool warm) {
+    AssertionEntry assertion;
+    InputType inputType = processAssertion(input.toUTF8(), assertion);
+    if (inputType == InputType::Assertion) {
+        return evaluateAssertion(assertion, warm);
+    }
+    if (inputType == InputType::InvalidAssertion) {
+        return { "Invalid Syntax", false, Stats{} };
     }
-    return newName;
+    return evaluate(input, nullptr, warm);
 }
 
-// α-Convert: Change the names of parameters to avoid from conflict
-ExprPtr alphaConvert(ExprPtr expr, const String& oldVar, const String& newVar) {
-    if (auto var = std::dynamic_pointer_cast<Variable>(expr)) {
-        if (var->name == oldVar) {
-            return std::make_shared<Variable>(newVar);
-        } else {
-            return var;
+// Handle REPL commands of the form ":name value".
+String Session::handleCommand(const std::string& input) {
+    std::istringstream stream(input);
+    std::string command, argument, extra;
+    stream >> command >> argument >> extra;
+    if (command == ":fuel") {
+        long value = argument.empty() ? -1 : std::atol(argument.c_str());
+        if (value <= 0) return "Usage: :fuel <max β-steps>";
+        stepLimit = value;
+        return "fuel limit set to " + std::to_string(value) + " steps";
+    }
+    if (command == ":trace") {
+        if (argument == "on") {
+            trace = true;
+            return "trace enabled";
         }
-    } else if (auto abstraction = std::dynamic_pointer_cast<Abstraction>(expr)) {
-        if (abstraction->param == oldVar) {
-            return std::make_shared<Abstraction>(newVar, alphaConvert(abstraction->body, oldVar, newVar));
-        } else {
-            return std::make_shared<Abstraction>(abstraction->param, alphaConvert(abstraction->body, oldVar, newVar));
+        if (argument == "off") {
+            trace = false;
+            return "trace disabled";
         }
-    } else if (auto application = std::dynamic_pointer_cast<Application>(expr)) {
-        return std::make_shared<Application>(
-            alphaConvert(application->func, oldVar, newVar),
-            alphaConvert(application->arg, oldVar, newVar)
-        );
+        return "Usage: :trace on|off";
     }
-    throw std::runtime_error("Unrecognized expression in alpha conversion");
-}
-
-// Replace the variable `varName` with `value` in expression.
-ExprPtr substitute(ExprPtr expr, const String& varName, ExprPtr value) {
-    if (auto var = std::dynamic_pointer_cast<Variable>(expr)) {
-        if (var->name == varName) {
-            return value;
-        } else {
-            return var;
+    if (command == ":par") {
+        if (argument == "on") {
+            parallel = true;
+            return "parallel reduction enabled";
         }
-    } else if (auto abstraction = std::dynamic_pointer_cast<Abstraction>(expr)) {
-        if (abstraction->param == varName) {
-            return abstraction;
-
-        // Prevent free variables from being captured.
-        } else if (occursIn(abstraction->param, value)) {
-            String newParamName = freshName(abstraction->param, value);
-            ExprPtr newBody = alphaConvert(abstraction->body, abstraction->param, newParamName);
-            return std::make_shared<Abstraction>(newParamName, substitute(newBody, varName, value));
-        } else {
-            return std::make_shared<Abstraction>(
-                abstraction->param,
-                substitute(abstraction->body, varName, value)
-            );
+        if (argument == "off") {
+            parallel = false;
+            return "parallel reduction disabled";
         }
-    } else if (auto application = std::dynamic_pointer_cast<Application>(expr)) {
-        return std::make_shared<Application>(
-            substitute(application->func, varName, value),
-            substitute(application->arg, varName, value)
-        );
+        return "Usage: :par on|off";
     }
-    throw std::runtime_error("Unrecognized expression in substitution");
-}
-
-// β-Reduce: Obtain the replaced steps.
-ExprPtr betaReduceStep(ExprPtr expr) {
-    if (auto application = std::dynamic_pointer_cast<Application>(expr)) {
-        if (auto abstraction = std::dynamic_pointer_cast<Abstraction>(application->func)) {
-            std::cout << Char{ 0x21aa } << " β-reduce: " << abstraction->param << " <- " << application->arg->toString() << std::endl;
-            return substitute(abstraction->body, abstraction->param, application->arg);
-        } else {
-            return std::make_shared<Application>(
-                betaReduceStep(application->func),
-                betaReduceStep(application->arg)
-            );
+    if (command == ":print") {
+        if (argument == "full") {
+            printLimit = 0;
+            printDepth = 0;
+            return "printing full terms";
         }
-    } else if (auto abstraction = std::dynamic_pointer_cast<Abstraction>(expr)) {
-        return std::make_shared<Abstraction>(abstraction->param, betaReduceStep(abstraction->body));
+        if (argument == "depth") {
+            long value = extra.empty() ? -1 : std::atol(extra.c_str());
+            if (value < 0) return "Usage: :print depth <levels, 0 to disable>";
+            printDepth = static_cast<int>(value);
+            return value == 0 ? String("depth limit disabled")
+                              : String("eliding below depth " + extra);
+        }
+        long value = argument.empty() ? -1 : std::atol(argument.c_str());
+        if (value < 0) return "Usage: :print full | :print <max bytes> | :print depth <levels>";
+        printLimit = static_cast<size_t>(value);
+        return value == 0 ? String("size limit disabled")
+                          : String("eliding beyond " + argument + " bytes");
+    }
+    if (command == ":stats") {
+        std::ostringstream out;
+        out << "β-steps:       " << lastStats.steps << "\n"
+            << "substitutions: " << lastStats.substitutions << "\n"
+            << "shifts:        " << lastStats.shifts << "\n"
+            << "nodes:         " << lastStats.nodes << "\n"
+            << "result size:   " << lastStats.resultSize << "\n"
+            << "result depth:  " << lastStats.resultDepth << "\n"
+            << "lex+parse:     " << lastStats.lexParseMs << " ms\n"
+            << "expand:        " << lastStats.expandMs << " ms\n"
+            << "compile:       " << lastStats.compileMs << " ms\n"
+            << "reduce:        " << lastStats.reduceMs << " ms\n"
+            << "print:         " << lastStats.printMs << " ms";
+        return String(out.str());
+    }
+    if (command == ":save" || command == ":load") {
+        if (argument.empty()) return "Usage: " + String(command) + " <file>";
+        try {
+            if (command == ":save") {
+                saveEnvironment(*env, argument);
+                return "environment saved to " + String(argument);
+            }
+            loadEnvironment(*env, argument);
+            return "environment loaded from " + String(argument);
+        } catch (const std::exception& e) {
+            return String("Error: ") + e.what();
+        }
+    }
+    if (command == ":engine") {
+        if (argument == "subst") {
+            machine = false;
+            return "engine set to substitution";
+        }
+        if (argument == "machine") {
+            machine = true;
+            return "engine set to environment machine";
+        }
+        return "Usage: :engine subst|machine";
+    }
+    if (command == ":maxsize") {
+        long value = argument.empty() ? -1 : std::atol(argument.c_str());
+        if (value < 0) return "Usage: :maxsize <max term nodes, 0 to disable>";
+        maxSize = value;
+        return value == 0 ? String("size limit disabled")
+                          : String("size limit set to " + std::to_string(value) + " nodes");
+    }
+    if (command == ":timeout") {
+        long value = argument.empty() ? -1 : std::atol(argument.c_str());
+        if (value < 0) return "Usage: :timeout <milliseconds, 0 to disable>";
+        timeoutMillis = value;
+        return value == 0 ? String("timeout disabled")
+                          : String("timeout set to " + std::to_string(value) + " ms");
+    }
+    if (command == ":reset") {
+        reset();
+        return "session reset: environment and caches dropped";
     }
-    return expr;
+    return "Unknown command: " + String(command);
 }
 
-// Determine if the expression has been reduced to its final form.
-bool isReduced(ExprPtr expr) {
-    if (auto application = std::dynamic_pointer_cast<Application>(expr)) {
-        return !(std::dynamic_pointer_cast<Abstraction>(application->func)) &&
-               isReduced(application->func) && isReduced(application->arg);
-    } else if (auto abstraction = std::dynamic_pointer_cast<Abstraction>(expr)) {
-        return isReduced(abstraction->body);
-    } else if (std::dynamic_pointer_cast<Variable>(expr)) {
-        return true;
-    }
-    return false;
+String Session::interpret(const String& input) {
+    std::string raw = input.toUTF8();
+    size_t first = raw.find_first_not_of(" \t");
+    if (first != std::string::npos && raw[first] == ':') {
+        return handleCommand(raw.substr(first));
+    }
+    BindingEntry entry;
+    InputType inputType = processBinding(input.toUTF8(), entry);
+    if (inputType == InputType::Binding) {
+        Result result = evaluate(entry.expr, &entry.name);
+        lastStats = result.stats;
+        if (!result.isOk) {
+            return result.value;
+        }
+        else return "<" + entry.name + "> " + result.value;
+    }
+    else if (inputType == InputType::Expression) {
+        Result result = dispatchExpression(input);
+        lastStats = result.stats;
+        return result.value;
+    }
+    else return "Invalid Syntax";
 }
 
-// Reduce expression to the final form.
-ExprPtr betaReduce(ExprPtr expr) {
-    while (!isReduced(expr)) {
-        expr = betaReduceStep(expr);
+// Let '\' be typed instead of 'λ'.
+std::string expandLambdaShorthand(std::string input) {
+    size_t pos = input.find('\\');
+    while (pos != std::string::npos) {
+        input.replace(pos, 1, "λ");
+        pos = input.find('\\', pos + 1);
     }
-    std::cout << "done." << std::endl;
-    return expr;
+    return input;
 }
 
-struct Result {
-    String value;
-    bool isOk;
-};
+// True for lines that touch shared state (commands and let-bindings);
+// such lines must run in program order and fence off parallel work.
+static bool isSequentialLine(const std::string& line) {
+    size_t first = line.find_first_not_of(" \t");
+    if (first != std::string::npos && line[first] == ':') return true;
+    BindingEntry entry;
+    return processBinding(line, entry) != InputType::Expression;
+}
 
-// Evaluate and β-Reduce the source expression.
-Result evaluate(const String& input) {
-    try {
-        Lexer lexer(input);
-        Parser parser(lexer.tokenize());
-        ExprPtr expression = parser.parse();
-        ExprPtr reducedExpression = betaReduce(expression);
-        return { reducedExpression->toString(), true };
-    } catch (const std::exception& e) {
-        return { String("Error: ") + e.what(), false };
+// Evaluate a run of independent expressions across the pool and print
+// the results in input order. The environment is not mutated between
+// bindings, so workers share it read-only; each task runs cold with its
+// own arena and reduction engine, since the session's warm caches are
+// single-threaded.
+static void flushParallel(ThreadPool& pool, std::vector<std::string>& pending) {
+    if (pending.empty()) return;
+    std::vector<String> results(pending.size());
+    std::vector<Stats> stats(pending.size());
+    for (size_t i = 0; i < pending.size(); ++i) {
+        pool.submit([&results, &stats, &pending, i] {
+            Result result = session.dispatchExpression(String{ pending[i] }, false);
+            results[i] = result.value;
+            stats[i] = result.stats;
+        });
+    }
+    pool.wait();
+    for (size_t i = 0; i < results.size(); ++i) {
+        std::cout << results[i] << "\n";
+        if (statsJsonSetting) std::cerr << statsJson(stats[i]) << "\n";
     }
+    pending.clear();
 }
 
-struct BindingEntry {
-    String name;
-    String expr;
-};
+// Stream a whole script through interpret() line by line: one process
+// handles an entire batch with buffered output and no readline at all.
+// Expressions between bindings/commands are independent of each other,
+// so they are fanned out across a worker pool; tracing forces the
+// sequential path to keep its output readable.
+int runStream(std::istream& in) {
+    ThreadPool pool;
+    std::vector<std::string> pending;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        line = expandLambdaShorthand(line);
+        // :par uses the shared reduction pool from inside evaluate(),
+        // so batch fan-out stands down while it is on.
+        if (pool.workerCount() <= 1 || session.trace || session.parallel ||
+            isSequentialLine(line)) {
+            flushParallel(pool, pending);
+            size_t first = line.find_first_not_of(" \t");
+            bool isCommand = first != std::string::npos && line[first] == ':';
+            std::cout << session.interpret(String{ line }) << "\n";
+            if (statsJsonSetting && !isCommand) std::cerr << statsJson(session.lastStats) << "\n";
+        } else {
+            pending.push_back(line);
+        }
+    }
+    flushParallel(pool, pending);
+    std::cout.flush();
+    return 0;
+}
 
-std::vector<BindingEntry> globalMapping;
+// --- Interactive-only UX ---------------------------------------------
+// Everything here runs solely under runRepl(): piped, scripted and -e
+// invocations never touch readline, so non-interactive startup pays
+// for none of it.
 
-enum class InputType {
-    Expression,
-    Binding, InvalidBinding,
-    Assertion, InvalidAssertion,
-};
+// Completion candidates (environment names plus commands), kept sorted
+// so a prefix maps to a contiguous range instead of a scan.
+std::vector<std::string> completionIndex;
 
-std::string trim(const std::string& str) {
-    std::string s = str;
-    s.erase(0, std::find_if(s.begin(), s.end(), [](unsigned char ch) {
-        return !std::isspace(ch);
-    }) - s.begin());
-    s.erase(std::find_if(s.rbegin(), s.rend(), [](unsigned char ch) {
-        return !std::isspace(ch);
-    }).base() - s.begin(), s.length());
-    std::replace(s.begin(), s.end(), ' ', '-');
-    return s;
+void rebuildCompletionIndex() {
+    completionIndex.clear();
+    for (const auto& binding : session.env->all()) {
+        completionIndex.push_back(symbols().utf8Name(binding.first));
+    }
+    for (const char* command : { ":engine", ":fuel", ":load", ":maxsize", ":par", ":print",
+                                 ":reset", ":save", ":stats", ":timeout", ":trace" }) {
+        completionIndex.push_back(command);
+    }
+    completionIndex.push_back("let");
+    std::sort(completionIndex.begin(), completionIndex.end());
 }
 
-InputType processBinding(const std::string& input) {
-    std::string trimmedInput = input.substr(input.find_first_not_of(' '));
-    if (trimmedInput.substr(0, 4) != "let ") {
-        return InputType::Expression;
+char* completionGenerator(const char* text, int state) {
+    static std::string prefix;
+    static size_t position;
+    if (state == 0) {
+        prefix = text;
+        position = std::lower_bound(completionIndex.begin(), completionIndex.end(), prefix) -
+                   completionIndex.begin();
     }
-    size_t wordStart = 4;
-    size_t wordEnd = trimmedInput.find('=', wordStart);
-    if (wordEnd == std::string::npos) {
-        return InputType::InvalidBinding;
+    if (position < completionIndex.size() &&
+        completionIndex[position].compare(0, prefix.size(), prefix) == 0) {
+        return strdup(completionIndex[position++].c_str());
     }
-    String word = trim(trimmedInput.substr(wordStart, wordEnd - wordStart));
-    String expression = trimmedInput.substr(wordEnd + 1);
-    globalMapping.push_back({ word, expression });
-    return InputType::Binding;
+    return nullptr;
 }
 
+char** lambdaCompletion(const char* text, int, int) {
+    rl_attempted_completion_over = 1; // never fall back to filenames
+    return rl_completion_matches(text, completionGenerator);
+}
 
-String interpret(const String& input) {
-    InputType inputType = processBinding(input.toUTF8());
-    if (inputType == InputType::Binding) {
-        auto entry = globalMapping.back();
-        Result result = evaluate(entry.expr);
-        if (!result.isOk) {
-            globalMapping.pop_back();
-            return result.value;
-        }
-        else return "<" + entry.name + "> " + result.value;
-    }
-    else if (inputType == InputType::Expression) {
-        Result result = evaluate(input);
-        return result.value;
-    }
-    else return "Invalid Syntax";
+std::string historyPath() {
+    const char* home = getenv("HOME");
+    return (home != nullptr ? std::string(home) : std::string(".")) + "/.lambda_history";
 }
 
-int main(int argc, char* argv[]) {
+int runRepl() {
+    rl_attempted_completion_function = lambdaCompletion;
+    rl_completer_word_break_characters = const_cast<char*>(" \t\n.()\\");
+    read_history(historyPath().c_str());
     std::string input;
     while (true) {
-        input = readline("λ> ");
-        if (input.empty()) if ((input = readline("λ> ")).empty()) break;
-        size_t pos = input.find('\\');
-        while (pos != std::string::npos) {
-            input.replace(pos, 1, "λ");
-            pos = input.find('\\', pos + 1);
+        rebuildCompletionIndex();
+        char* raw = readline("λ> ");
+        if (raw == nullptr) break; // EOF
+        input = raw;
+        free(raw);
+        if (input.empty()) {
+            raw = readline("λ> ");
+            if (raw == nullptr) break;
+            input = raw;
+            free(raw);
+            if (input.empty()) break;
         }
+        input = expandLambdaShorthand(input);
         add_history(input.c_str());
-        std::cout << " - " << input << " - \n" << interpret(String{ input }) << "\n" << std::endl;
+        std::cout << " - " << input << " - \n" << session.interpret(String{ input }) << "\n" << std::endl;
     }
+    write_history(historyPath().c_str());
     return 0;
 }
 
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && std::string(argv[1]) == "--stats-json") {
+        statsJsonSetting = true;
+        --argc;
+        ++argv;
+    }
+    if (argc >= 2 && std::string(argv[1]) == "-e") {
+        if (argc < 3) {
+            std::cerr << "Usage: lambda -e <expression>" << std::endl;
+            return 1;
+        }
+        std::cout << session.interpret(String{ expandLambdaShorthand(argv[2]) }) << std::endl;
+        return 0;
+    }
+    if (argc >= 2) {
+        std::ifstream file(argv[1]);
+        if (!file) {
+            std::cerr << "Cannot open script file: " << argv[1] << std::endl;
+            return 1;
+        }
+        return runStream(file);
+    }
+    if (!isatty(fileno(stdin))) {
+        return runStream(std::cin);
+    }
+    return runRepl();
+}
@@ -0,0 +1,220 @@
+#ifndef _PARSER_HH_
+#define _PARSER_HH_
+
+#include <cctype>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "arena.hh"
+#include "expr.hh"
+#include "string.hh"
+#include "symbol.hh"
+
+enum class TokenType { VARIABLE, NUMBER, LAMBDA, DOT, LPAREN, RPAREN, END };
+
+// Largest numeral literal the parser will desugar, matching the
+// reducer's native-arithmetic bound. Desugaring happens before :fuel
+// and :maxsize can see it, so the cap is what keeps a pasted
+// 2000000000 from allocating two billion nodes at parse time.
+const long maxNumeralLiteral = 1000000;
+
+struct Token {
+    TokenType type;
+    Symbol value; // interned name for VARIABLE, numeric value for NUMBER
+    Token(TokenType t, Symbol v = 0) : type(t), value(v) {}
+};
+
+// Pull-based lexer over the raw UTF-8 bytes of the source: the Parser
+// asks for one token at a time, so no token vector is ever built and
+// nothing is copied -- codepoints are decoded inline and identifiers
+// interned straight from the byte slice. The caller keeps the source
+// buffer alive until the next reset; reset() rebinds an existing Lexer
+// to a new expression with no construction cost.
+class Lexer {
+public:
+    Lexer() : input(nullptr), position(0) {}
+    explicit Lexer(const std::string& source) : input(&source), position(0) {}
+
+    void reset(const std::string& source) {
+        input = &source;
+        position = 0;
+    }
+
+    // Produce the next token; END once the source is exhausted.
+    Token next() {
+        const std::string& in = *input;
+        while (position < in.size() &&
+               isspace(static_cast<unsigned char>(in[position]))) {
+            ++position;
+        }
+        if (position >= in.size()) return Token(TokenType::END);
+
+        size_t start = position;
+        int current = decodeUTF8(in, position);
+        if (current == 0x03BB) return Token(TokenType::LAMBDA); // λ
+        if (current == '.') return Token(TokenType::DOT);
+        if (current == '(') return Token(TokenType::LPAREN);
+        if (current == ')') return Token(TokenType::RPAREN);
+        if (current < 0x80 && isdigit(current)) {
+            // A numeral literal; desugared by the Parser into the
+            // corresponding Church numeral. Accumulated in a long and
+            // bounded, so oversized literals are a parse error instead
+            // of a silently truncated value.
+            long value = current - '0';
+            while (position < in.size() &&
+                   isdigit(static_cast<unsigned char>(in[position]))) {
+                value = value * 10 + (in[position] - '0');
+                if (value > maxNumeralLiteral) {
+                    throw std::runtime_error(
+                        "Numeral literal exceeds " + std::to_string(maxNumeralLiteral));
+                }
+                ++position;
+            }
+            return Token(TokenType::NUMBER, static_cast<Symbol>(value));
+        }
+        if (!(current < 0x80 && isspace(current))) {
+            // A variable is a run of codepoints up to the next
+            // delimiter, so bound names like `id` are referencable.
+            while (position < in.size()) {
+                size_t next = position;
+                int ch = decodeUTF8(in, next);
+                if (ch == 0x03BB || ch == '.' || ch == '(' || ch == ')' ||
+                    (ch < 0x80 && isspace(ch))) {
+                    break;
+                }
+                position = next;
+            }
+            return Token(TokenType::VARIABLE,
+                         symbols().intern(in.substr(start, position - start)));
+        }
+        throw std::runtime_error("Unexpected character encountered");
+    }
+
+private:
+    const std::string* input;
+    size_t position;
+};
+
+// Single-pass parser consuming tokens on demand from its Lexer. The
+// grammar is unchanged -- applications are left-associative runs of
+// variables, numerals and groups; a λ body extends to the end of the
+// enclosing group -- but descent is driven by an explicit context
+// stack, so nesting depth is bounded by memory rather than the C
+// stack, and a reset() parser keeps its stack capacity from one
+// expression to the next.
+class Parser {
+public:
+    Parser() : lexer(nullptr), arena(nullptr) {}
+    Parser(Lexer& lexer, Arena& arena) : lexer(&lexer), arena(&arena) {}
+
+    void reset(Lexer& newLexer, Arena& newArena) {
+        lexer = &newLexer;
+        arena = &newArena;
+    }
+
+    ExprPtr parse() {
+        frames.clear();
+        // The application accumulated in the current context; null at
+        // the start of an expression.
+        ExprPtr app = nullptr;
+        auto operand = [&](ExprPtr expr) {
+            app = app == nullptr ? expr : arena->make<Application>(app, expr);
+        };
+        // A completed body closes every pending λ down to the next
+        // group boundary.
+        auto closeLambdas = [&] {
+            while (!frames.empty() && !frames.back().paren) {
+                if (app == nullptr) throw std::runtime_error("Unexpected term");
+                Frame& frame = frames.back();
+                for (auto it = frame.params.rbegin(); it != frame.params.rend(); ++it) {
+                    app = arena->make<Abstraction>(*it, app);
+                }
+                frames.pop_back();
+            }
+        };
+        while (true) {
+            Token token = lexer->next();
+            switch (token.type) {
+            case TokenType::VARIABLE:
+                operand(arena->make<Variable>(token.value));
+                break;
+            case TokenType::NUMBER:
+                operand(churchNumeral(token.value));
+                break;
+            case TokenType::LPAREN:
+                frames.push_back({ true, {}, app });
+                app = nullptr;
+                break;
+            case TokenType::RPAREN: {
+                closeLambdas();
+                if (app == nullptr) throw std::runtime_error("Unexpected term");
+                if (frames.empty()) return app; // input past a balanced expression is ignored
+                Frame frame = std::move(frames.back());
+                frames.pop_back();
+                app = frame.saved == nullptr ? app : arena->make<Application>(frame.saved, app);
+                break;
+            }
+            case TokenType::LAMBDA: {
+                // A λ after an operand terminates the application, as
+                // it always has; mid-group that leaves the paren
+                // unclosed.
+                if (app != nullptr) {
+                    closeLambdas();
+                    if (!frames.empty()) {
+                        throw std::runtime_error("Expected closing parenthesis");
+                    }
+                    return app;
+                }
+                Frame frame{ false, {}, nullptr };
+                Token param = lexer->next();
+                while (param.type == TokenType::VARIABLE) {
+                    frame.params.push_back(param.value);
+                    param = lexer->next();
+                }
+                if (param.type != TokenType::DOT) {
+                    throw std::runtime_error("Expected '.' after lambda parameters");
+                }
+                frames.push_back(std::move(frame));
+                break;
+            }
+            case TokenType::DOT:
+                throw std::runtime_error("Unexpected term");
+            case TokenType::END:
+                closeLambdas();
+                if (!frames.empty()) {
+                    throw std::runtime_error("Expected closing parenthesis");
+                }
+                if (app == nullptr) throw std::runtime_error("Unexpected term");
+                return app;
+            }
+        }
+    }
+
+private:
+    // One pending group or λ: a paren frame saves the application it
+    // interrupted, a λ frame holds the parameters awaiting their body.
+    struct Frame {
+        bool paren;
+        std::vector<Symbol> params;
+        ExprPtr saved;
+    };
+
+    Lexer* lexer;
+    Arena* arena;
+    std::vector<Frame> frames;
+
+    // n desugars to the Church numeral λf.λx.f (f ... (f x)). The
+    // numeral is closed, so the fixed parameter names can never capture
+    // anything.
+    ExprPtr churchNumeral(long n) {
+        Symbol f = symbols().intern(std::string("f"));
+        Symbol x = symbols().intern(std::string("x"));
+        ExprPtr body = arena->make<Variable>(x);
+        for (long i = 0; i < n; ++i) {
+            body = arena->make<Application>(arena->make<Variable>(f), body);
+        }
+        return arena->make<Abstraction>(f, arena->make<Abstraction>(x, body));
+    }
+};
+
+#endif // !_PARSER_HH_
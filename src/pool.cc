@@ -0,0 +1,51 @@
+#include "pool.hh"
+
+ThreadPool::ThreadPool(unsigned workers) {
+    if (workers == 0) workers = 1;
+    threads.reserve(workers);
+    for (unsigned i = 0; i < workers; ++i) {
+        threads.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    ready.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return tasks.empty() && active == 0; });
+}
+
+void ThreadPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        ready.wait(lock, [this] { return stopping || !tasks.empty(); });
+        if (tasks.empty()) break; // stopping, queue drained
+        std::function<void()> task = std::move(tasks.front());
+        tasks.pop_front();
+        ++active;
+        lock.unlock();
+        task();
+        lock.lock();
+        --active;
+        if (tasks.empty() && active == 0) {
+            idle.notify_all();
+        }
+    }
+}
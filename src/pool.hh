@@ -0,0 +1,43 @@
+#ifndef _POOL_HH_
+#define _POOL_HH_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size worker pool with a shared task queue. Batch evaluation
+// submits one task per independent expression and waits for the lot;
+// tasks must not touch shared mutable state (each evaluation owns its
+// arena and reduction engine, and the environment is frozen while a
+// batch is in flight).
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned workers = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Block until every submitted task has finished.
+    void wait();
+
+    size_t workerCount() const { return threads.size(); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> threads;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::condition_variable idle;
+    size_t active = 0;
+    bool stopping = false;
+};
+
+#endif // !_POOL_HH_
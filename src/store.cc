@@ -0,0 +1,187 @@
+#include "store.hh"
+
+#include <cstdint>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+#include "arena.hh"
+#include "expr.hh"
+#include "symbol.hh"
+
+// Layout, little-endian:
+//   "LMB1"
+//   u32 symbolCount, then per symbol: u32 byteLength + UTF-8 bytes
+//   u32 bindingCount, then per binding: u32 name, preorder expression
+// Expressions are tag bytes -- 0 Var(u32 name), 1 Abs(u32 param, body),
+// 2 App(func, arg) -- with all symbols as file-local IDs.
+
+static const char magic[4] = { 'L', 'M', 'B', '1' };
+
+static void writeU32(std::ostream& out, uint32_t value) {
+    char bytes[4] = { static_cast<char>(value), static_cast<char>(value >> 8),
+                      static_cast<char>(value >> 16), static_cast<char>(value >> 24) };
+    out.write(bytes, 4);
+}
+
+static uint32_t readU32(std::istream& in) {
+    unsigned char bytes[4];
+    in.read(reinterpret_cast<char*>(bytes), 4);
+    if (!in) throw std::runtime_error("Truncated environment file");
+    return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+           (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+// Assign file-local IDs in first-seen order so the symbol section only
+// carries names this environment actually uses.
+struct LocalSymbols {
+    std::unordered_map<Symbol, uint32_t> ids;
+    std::vector<Symbol> order;
+    uint32_t resolve(Symbol name) {
+        auto found = ids.find(name);
+        if (found != ids.end()) return found->second;
+        uint32_t id = static_cast<uint32_t>(order.size());
+        ids.emplace(name, id);
+        order.push_back(name);
+        return id;
+    }
+};
+
+static void collectSymbols(ExprPtr expr, LocalSymbols& local) {
+    std::vector<ExprPtr> stack{ expr };
+    while (!stack.empty()) {
+        ExprPtr node = stack.back();
+        stack.pop_back();
+        switch (node->kind) {
+        case ExprKind::Variable:
+            local.resolve(asVariable(node)->name);
+            break;
+        case ExprKind::Abstraction:
+            local.resolve(asAbstraction(node)->param);
+            stack.push_back(asAbstraction(node)->body);
+            break;
+        case ExprKind::Application:
+            stack.push_back(asApplication(node)->arg);
+            stack.push_back(asApplication(node)->func);
+            break;
+        }
+    }
+}
+
+static void writeExpr(std::ostream& out, ExprPtr expr, LocalSymbols& local) {
+    std::vector<ExprPtr> stack{ expr };
+    while (!stack.empty()) {
+        ExprPtr node = stack.back();
+        stack.pop_back();
+        switch (node->kind) {
+        case ExprKind::Variable:
+            out.put(0);
+            writeU32(out, local.resolve(asVariable(node)->name));
+            break;
+        case ExprKind::Abstraction:
+            out.put(1);
+            writeU32(out, local.resolve(asAbstraction(node)->param));
+            stack.push_back(asAbstraction(node)->body);
+            break;
+        case ExprKind::Application:
+            out.put(2);
+            stack.push_back(asApplication(node)->arg);
+            stack.push_back(asApplication(node)->func);
+            break;
+        }
+    }
+}
+
+void saveEnvironment(const Environment& env, const std::string& path) {
+    // Two passes: symbols must precede expressions in the file, and the
+    // symbol section is only complete after seeing every binding.
+    LocalSymbols local;
+    for (const auto& binding : env.all()) {
+        local.resolve(binding.first);
+        collectSymbols(binding.second.value, local);
+    }
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw std::runtime_error("Cannot write environment file: " + path);
+    out.write(magic, 4);
+    writeU32(out, static_cast<uint32_t>(local.order.size()));
+    for (Symbol name : local.order) {
+        const std::string& utf8 = symbols().utf8Name(name);
+        writeU32(out, static_cast<uint32_t>(utf8.size()));
+        out.write(utf8.data(), utf8.size());
+    }
+    writeU32(out, static_cast<uint32_t>(env.all().size()));
+    for (const auto& binding : env.all()) {
+        writeU32(out, local.resolve(binding.first));
+        writeExpr(out, binding.second.value, local);
+    }
+    if (!out) throw std::runtime_error("Write failed: " + path);
+}
+
+// Rebuild one preorder expression; parents wait on an explicit stack
+// and completed children cascade upward.
+static ExprPtr readExpr(std::istream& in, const std::vector<Symbol>& names, Arena& arena) {
+    struct Pending { ExprPtr node; int remaining; };
+    std::vector<Pending> parents;
+    auto localName = [&](uint32_t id) {
+        if (id >= names.size()) throw std::runtime_error("Bad symbol ID in environment file");
+        return names[id];
+    };
+    while (true) {
+        int tag = in.get();
+        if (tag < 0) throw std::runtime_error("Truncated environment file");
+        ExprPtr completed = nullptr;
+        if (tag == 0) {
+            completed = arena.make<Variable>(localName(readU32(in)));
+        } else if (tag == 1) {
+            parents.push_back({ arena.make<Abstraction>(localName(readU32(in)), nullptr), 1 });
+        } else if (tag == 2) {
+            parents.push_back({ arena.make<Application>(nullptr, nullptr), 2 });
+        } else {
+            throw std::runtime_error("Bad node tag in environment file");
+        }
+        while (completed != nullptr) {
+            if (parents.empty()) return completed;
+            Pending& parent = parents.back();
+            if (parent.node->kind == ExprKind::Abstraction) {
+                asAbstraction(parent.node)->body = completed;
+            } else if (asApplication(parent.node)->func == nullptr) {
+                asApplication(parent.node)->func = completed;
+            } else {
+                asApplication(parent.node)->arg = completed;
+            }
+            if (--parent.remaining > 0) break;
+            completed = parent.node;
+            parents.pop_back();
+        }
+    }
+}
+
+void loadEnvironment(Environment& env, const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("Cannot open environment file: " + path);
+    char header[4];
+    in.read(header, 4);
+    if (!in || std::string(header, 4) != std::string(magic, 4)) {
+        throw std::runtime_error("Not an environment file: " + path);
+    }
+    uint32_t symbolCount = readU32(in);
+    std::vector<Symbol> names;
+    names.reserve(symbolCount);
+    std::string spelling;
+    for (uint32_t i = 0; i < symbolCount; ++i) {
+        spelling.resize(readU32(in));
+        in.read(&spelling[0], spelling.size());
+        if (!in) throw std::runtime_error("Truncated environment file");
+        names.push_back(symbols().intern(spelling));
+    }
+    uint32_t bindingCount = readU32(in);
+    // Stage into a scratch arena; define() clones into the environment's
+    // own arena, matching how evaluated bindings arrive.
+    Arena arena;
+    for (uint32_t i = 0; i < bindingCount; ++i) {
+        Symbol name = names.at(readU32(in));
+        // Snapshots carry normalized values; the value doubles as the
+        // source, so loaded bindings behave as already-fresh entries.
+        ExprPtr value = readExpr(in, names, arena);
+        env.define(name, value, value);
+    }
+}
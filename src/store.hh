@@ -0,0 +1,15 @@
+#ifndef _STORE_HH_
+#define _STORE_HH_
+
+#include <string>
+#include "env.hh"
+
+// Binary snapshots of the global environment (:save / :load). Bindings
+// are stored post-parse and post-normalization with file-local symbol
+// IDs, so a new process gets its whole prelude back with one file read
+// and a re-intern -- no lexing, parsing or reduction. Both functions
+// throw std::runtime_error on I/O or format problems.
+void saveEnvironment(const Environment& env, const std::string& path);
+void loadEnvironment(Environment& env, const std::string& path);
+
+#endif // !_STORE_HH_
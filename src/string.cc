@@ -1,141 +1,162 @@
 #include "string.hh"
 
-Char::Char() : data(), size(0) {}
+#include <cstdint>
+#include <cstring>
 
-Char::Char(const std::string& utf8) : data(utf8), size(utf8.size()) {}
+// Decode one codepoint starting at `i`, advancing it past the
+// sequence.
+int decodeUTF8(const std::string& utf8, size_t& i) {
+    unsigned char lead = static_cast<unsigned char>(utf8[i]);
+    size_t charLen = 1;
+    int codepoint = lead;
+    if ((lead & 0x80) == 0) {
+    }
+    else if ((lead & 0xE0) == 0xC0) {
+        charLen = 2;
+        codepoint = lead & 0x1F;
+    }
+    else if ((lead & 0xF0) == 0xE0) {
+        charLen = 3;
+        codepoint = lead & 0x0F;
+    }
+    else if ((lead & 0xF8) == 0xF0) {
+        charLen = 4;
+        codepoint = lead & 0x07;
+    }
+    else {
+        throw std::runtime_error("Invalid UTF-8 encoding");
+    }
+    if (i + charLen > utf8.size()) {
+        throw std::runtime_error("Invalid UTF-8 encoding");
+    }
+    for (size_t k = 1; k < charLen; ++k) {
+        codepoint = (codepoint << 6) | (static_cast<unsigned char>(utf8[i + k]) & 0x3F);
+    }
+    i += charLen;
+    return codepoint;
+}
 
-Char::Char(char c) : data(1, c), size(1) {}
+// Append the UTF-8 encoding of a codepoint.
+void encodeUTF8(int unicode, std::string& out) {
+    if (unicode < 0x80) {
+        out += static_cast<char>(unicode);
+    }
+    else if (unicode < 0x800) {
+        out += static_cast<char>(0xC0 | (unicode >> 6));
+        out += static_cast<char>(0x80 | (unicode & 0x3F));
+    }
+    else if (unicode < 0x10000) {
+        out += static_cast<char>(0xE0 | (unicode >> 12));
+        out += static_cast<char>(0x80 | ((unicode >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (unicode & 0x3F));
+    }
+    else if (unicode <= 0x10FFFF) {
+        out += static_cast<char>(0xF0 | (unicode >> 18));
+        out += static_cast<char>(0x80 | ((unicode >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((unicode >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (unicode & 0x3F));
+    }
+    else {
+        throw std::invalid_argument("Invalid Unicode code point");
+    }
+}
+
+Char::Char() : codepoint(0) {}
+
+Char::Char(const std::string& utf8) : codepoint(0) {
+    if (!utf8.empty()) {
+        size_t i = 0;
+        codepoint = decodeUTF8(utf8, i);
+    }
+}
+
+Char::Char(char c) : codepoint(static_cast<unsigned char>(c)) {}
 
 Char::Char(int c) {
-    data = fromCodepoint(c).toUTF8();
-    size = data.size();
+    if (c < 0 || c > 0x10FFFF) {
+        throw std::invalid_argument("Invalid Unicode code point");
+    }
+    codepoint = static_cast<char32_t>(c);
 }
 
-Char::Char(const char* cstr) : data(cstr ? cstr : ""), size(cstr ? std::strlen(cstr) : 0) {}
+Char::Char(const char* cstr) : Char(cstr ? std::string(cstr) : std::string()) {}
 
 Char& Char::operator=(const char* cstr) {
-    if (cstr) {
-        data = std::string(cstr);
-        size = data.size();
-    }
-    else {
-        data.clear();
-        size = 0;
-    }
+    *this = Char(cstr);
     return *this;
 }
 
 Char& Char::operator=(char c) {
-    data = std::string(1, c);
-    size = 1;
+    codepoint = static_cast<unsigned char>(c);
     return *this;
 }
 
 bool Char::isASCII() const {
-    return size == 1 && data[0] < 0x80;
+    return codepoint < 0x80;
 }
 
 char Char::toStdChar() const {
-    return data[0];
+    return static_cast<char>(codepoint);
 }
 
 bool Char::isStdDigit() const {
-    return std::isdigit(data[0]);
+    return isASCII() && std::isdigit(static_cast<int>(codepoint));
 }
 
 bool Char::isStdAlpha() const {
-    return std::isalpha(data[0]);
+    return isASCII() && std::isalpha(static_cast<int>(codepoint));
 }
 
 bool Char::isStdAlnum() const {
-    return std::isalnum(data[0]);
+    return isASCII() && std::isalnum(static_cast<int>(codepoint));
 }
 
 bool Char::isSingle() const {
-    return size == 1;
+    return codepoint < 0x80;
 }
 
 std::string Char::toUTF8() const {
-    return data;
+    std::string utf8;
+    encodeUTF8(static_cast<int>(codepoint), utf8);
+    return utf8;
 }
 
 bool Char::operator==(const Char& other) const {
-    return data == other.data;
+    return codepoint == other.codepoint;
 }
 
 bool Char::operator!=(const Char& other) const {
-    return data != other.data;
+    return codepoint != other.codepoint;
 }
 
-
-bool Char::operator<(const Char& other) const
-{
-    std::string s1 = data;
-    std::string s2 = other.data;
-    if (s1.length() < s2.length()) {
-        return true;
-    }
-    else if (s1.length() > s2.length()) {
-        return false;
-    }
-
-    for (size_t i = 0; i < s1.length(); ++i) {
-        if (s1[i] < s2[i]) {
-            return true;
-        }
-        else if (s1[i] > s2[i]) {
-            return false;
-        }
-    }
-    return false;
+// Codepoint order coincides with the old (length, bytes) order of the
+// UTF-8 encodings.
+bool Char::operator<(const Char& other) const {
+    return codepoint < other.codepoint;
 }
 
-bool Char::operator<=(const Char& other) const
-{
-    return *this < other || *this == other;
+bool Char::operator<=(const Char& other) const {
+    return codepoint <= other.codepoint;
 }
 
-bool Char::operator>(const Char& other) const
-{
-    return !(*this <= other);
+bool Char::operator>(const Char& other) const {
+    return codepoint > other.codepoint;
 }
 
-bool Char::operator>=(const Char& other) const
-{
-    return !(*this < other);
+bool Char::operator>=(const Char& other) const {
+    return codepoint >= other.codepoint;
 }
 
 Char Char::operator+(int n) const {
-    int codepoint = this->toCodepoint();
-    return fromCodepoint(codepoint + n);
+    return Char(static_cast<int>(codepoint) + n);
 }
 
 Char Char::operator-(int n) const {
-    int codepoint = this->toCodepoint();
-    return fromCodepoint(codepoint - n);
+    return Char(static_cast<int>(codepoint) - n);
 }
 
 int Char::toCodepoint() const {
-    unsigned char bytes[4];
-    std::memcpy(bytes, data.data(), data.size());
-    int codepoint = 0;
-    switch (data.size()) {
-    case 1:
-        codepoint = bytes[0];
-        break;
-    case 2:
-        codepoint = (((bytes[0] & 0x1F) << 6) | (bytes[1] & 0x3F));
-        break;
-    case 3:
-        codepoint = (((bytes[0] & 0x0F) << 12) | ((bytes[1] & 0x3F) << 6) | (bytes[2] & 0x3F));
-        break;
-    case 4:
-        codepoint = (((bytes[0] & 0x07) << 18) | ((bytes[1] & 0x3F) << 12) | ((bytes[2] & 0x3F) << 6) | (bytes[3] & 0x3F));
-        break;
-    default:
-        throw std::invalid_argument("Invalid UTF-8 encoding");
-    }
-    return codepoint;
+    return static_cast<int>(codepoint);
 }
 
 std::ostream& operator<<(std::ostream& os, const Char& ch) {
@@ -149,47 +170,40 @@ String::String(Char ch) : chars({ ch }) {}
 String::String(std::vector<Char> vec) : chars(vec) {}
 
 String::String(const std::string& utf8) {
-    for (size_t i = 0; i < utf8.size();) {
-        size_t charLen = 1;
-        if ((utf8[i] & 0x80) == 0) {
-        }
-        else if ((utf8[i] & 0xE0) == 0xC0) {
-            charLen = 2;
-        }
-        else if ((utf8[i] & 0xF0) == 0xE0) {
-            charLen = 3;
-        }
-        else if ((utf8[i] & 0xF8) == 0xF0) {
-            charLen = 4;
+    // One upfront reserve: codepoints never outnumber bytes.
+    chars.reserve(utf8.size());
+    const size_t n = utf8.size();
+    size_t i = 0;
+    while (i < n) {
+        // SWAR fast path: a word with no high bit set is eight ASCII
+        // bytes, decoded without touching the per-sequence logic.
+        // Machine-generated term files are almost entirely ASCII, so
+        // most of a multi-megabyte input takes this lane.
+        while (n - i >= 8) {
+            uint64_t chunk;
+            std::memcpy(&chunk, utf8.data() + i, 8);
+            if (chunk & UINT64_C(0x8080808080808080)) break;
+            for (size_t k = 0; k < 8; ++k) {
+                chars.push_back(Char(utf8[i + k]));
+            }
+            i += 8;
         }
-        if (i + charLen > utf8.size()) {
-            throw std::runtime_error("Invalid UTF-8 encoding");
+        if (i >= n) break;
+        // Slow path for the tail and for any chunk holding a multibyte
+        // sequence; ASCII bytes here still skip the length dispatch.
+        if (static_cast<unsigned char>(utf8[i]) < 0x80) {
+            chars.push_back(Char(utf8[i]));
+            ++i;
+        } else {
+            chars.push_back(Char(decodeUTF8(utf8, i)));
         }
-        chars.push_back(Char(utf8.substr(i, charLen)));
-        i += charLen;
     }
 }
 
 String::String(int num) {
     std::string numStr = std::to_string(num);
-    for (size_t i = 0; i < numStr.size();) {
-        size_t charLen = 1;
-        if ((numStr[i] & 0x80) == 0) {
-        }
-        else if ((numStr[i] & 0xE0) == 0xC0) {
-            charLen = 2;
-        }
-        else if ((numStr[i] & 0xF0) == 0xE0) {
-            charLen = 3;
-        }
-        else if ((numStr[i] & 0xF8) == 0xF0) {
-            charLen = 4;
-        }
-        if (i + charLen > numStr.size()) {
-            throw std::runtime_error("Invalid UTF-8 encoding");
-        }
-        chars.push_back(Char(numStr.substr(i, charLen)));
-        i += charLen;
+    for (char c : numStr) {
+        chars.push_back(Char(c));
     }
 }
 
@@ -339,7 +353,7 @@ Char String::operator[](size_t index) const {
     if (index >= chars.size()) {
         return {};
     }
-    return  { chars[index].toUTF8() };
+    return chars[index];
 }
 
 std::string String::toUTF8() const {
@@ -386,34 +400,7 @@ String& operator+=(String& lhs, const String& rhs) {
 }
 
 Char fromCodepoint(int unicode) {
-    std::string utf8;
-    if (unicode < 0x80) {
-        // 1-byte sequence
-        utf8 += static_cast<char>(unicode);
-    }
-    else if (unicode < 0x800) {
-        // 2-byte sequence
-        utf8 += static_cast<char>(0xC0 | (unicode >> 6));
-        utf8 += static_cast<char>(0x80 | (unicode & 0x3F));
-    }
-    else if (unicode < 0x10000) {
-        // 3-byte sequence
-        utf8 += static_cast<char>(0xE0 | (unicode >> 12));
-        utf8 += static_cast<char>(0x80 | ((unicode >> 6) & 0x3F));
-        utf8 += static_cast<char>(0x80 | (unicode & 0x3F));
-    }
-    else if (unicode <= 0x10FFFF) {
-        // 4-byte sequence
-        utf8 += static_cast<char>(0xF0 | (unicode >> 18));
-        utf8 += static_cast<char>(0x80 | ((unicode >> 12) & 0x3F));
-        utf8 += static_cast<char>(0x80 | ((unicode >> 6) & 0x3F));
-        utf8 += static_cast<char>(0x80 | (unicode & 0x3F));
-    }
-    else {
-        // Invalid Unicode code point
-        throw std::invalid_argument("Invalid Unicode code point");
-    }
-    return { utf8 };
+    return Char(unicode);
 }
 
 String toHexString(int number) {
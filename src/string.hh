@@ -9,6 +9,9 @@
 
 class String;
 
+// A Char is one Unicode codepoint stored inline as char32_t — four
+// bytes, no heap allocation — encoded to UTF-8 only on demand. A
+// String's vector<Char> is therefore a dense array of codepoints.
 class Char {
 public:
     Char();
@@ -37,8 +40,7 @@ public:
     friend std::ostream& operator<<(std::ostream& os, const Char& ch);
 
 private:
-    std::string data;
-    size_t size;
+    char32_t codepoint;
 };
 
 class String {
@@ -96,6 +98,8 @@ String operator+(const String& lhs, const String& rhs);
 String& operator+=(String& lhs, const String& rhs);
 
 Char fromCodepoint(int unicode);
+int decodeUTF8(const std::string& utf8, size_t& i);
+void encodeUTF8(int unicode, std::string& out);
 String toHexString(int number);
 int toInteger(String s);
 
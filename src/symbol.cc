@@ -0,0 +1,47 @@
+#include "symbol.hh"
+
+#include <mutex>
+
+Symbol SymbolTable::intern(const std::string& utf8) {
+    {
+        std::shared_lock<std::shared_mutex> reading(lock);
+        auto found = ids.find(utf8);
+        if (found != ids.end()) {
+            return found->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> writing(lock);
+    auto found = ids.find(utf8);
+    if (found != ids.end()) {
+        return found->second;
+    }
+    Symbol id = static_cast<Symbol>(names.size());
+    names.push_back(String(utf8));
+    utf8Names.push_back(utf8);
+    ids.emplace(utf8, id);
+    return id;
+}
+
+Symbol SymbolTable::intern(const String& name) {
+    return intern(name.toUTF8());
+}
+
+const String& SymbolTable::name(Symbol id) const {
+    std::shared_lock<std::shared_mutex> reading(lock);
+    return names[id];
+}
+
+const std::string& SymbolTable::utf8Name(Symbol id) const {
+    std::shared_lock<std::shared_mutex> reading(lock);
+    return utf8Names[id];
+}
+
+size_t SymbolTable::size() const {
+    std::shared_lock<std::shared_mutex> reading(lock);
+    return names.size();
+}
+
+SymbolTable& symbols() {
+    static SymbolTable table;
+    return table;
+}
@@ -0,0 +1,39 @@
+#ifndef _SYMBOL_HH_
+#define _SYMBOL_HH_
+
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "string.hh"
+
+// Interned variable names. Each distinct name is resolved once (in the
+// Parser) to a small integer ID, so every name comparison in the
+// evaluator is a single integer compare and AST nodes store 4 bytes
+// instead of a String. The table is shared by every batch worker, so
+// interning takes a writer lock and lookups a reader lock; spellings
+// live in deques so references handed out stay valid across growth.
+using Symbol = uint32_t;
+
+class SymbolTable {
+public:
+    Symbol intern(const String& name);
+    Symbol intern(const std::string& utf8);
+    const String& name(Symbol id) const;
+    // The UTF-8 spelling, cached so printers can append bytes directly.
+    const std::string& utf8Name(Symbol id) const;
+    size_t size() const;
+
+private:
+    mutable std::shared_mutex lock;
+    std::unordered_map<std::string, Symbol> ids;
+    std::deque<String> names;
+    std::deque<std::string> utf8Names;
+};
+
+// Process-wide table shared by parser, environment and printer.
+SymbolTable& symbols();
+
+#endif // !_SYMBOL_HH_